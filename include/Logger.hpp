@@ -14,6 +14,9 @@
 
 #include <iostream>
 #include <string>
+#include <string_view>
+#include <array>
+#include <span>
 #include <mutex>
 #include <atomic>
 #include <chrono>
@@ -21,10 +24,56 @@
 #include <cstdio>
 #include <cstring>
 #include <cstdarg>
+#include <cerrno>
 #include <memory>
+#include <new>
+#include <cstdlib>
 #include <type_traits>
 #include <charconv>
+#include <limits>
 #include <source_location>
+#ifdef _WIN32
+#include <io.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#else
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#define LOGGER_HAS_MMAP 1
+#endif
+#ifdef __linux__
+#include <sys/resource.h>
+#endif
+#if defined(LOGGER_WITH_ZLIB) && __has_include(<zlib.h>)
+#include <zlib.h>
+#define LOGGER_HAS_ZLIB 1
+#endif
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#define LOGGER_HAS_IO_URING 1
+#endif
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#include <cpuid.h>
+#endif
+#define LOGGER_HAS_RDTSC 1
+#endif
+#include <thread>
+#include <vector>
+#include <condition_variable>
+#include <algorithm>
+#include <functional>
+#include <map>
+#include <tuple>
+#include <filesystem>
+#include <fstream>
+#include <cctype>
 
 /**
  * @brief 日志级别枚举
@@ -38,6 +87,32 @@ enum LogLevel {
     ERROR    ///< 错误信息
 };
 
+/**
+ * @brief LOGGER_ACTIVE_LEVEL 的取值
+ */
+#define LOGGER_LEVEL_DEBUG   0
+#define LOGGER_LEVEL_INFO    1
+#define LOGGER_LEVEL_WARNING 2
+#define LOGGER_LEVEL_ERROR   3
+#define LOGGER_LEVEL_OFF     4
+
+/**
+ * @brief 编译期最低日志级别（默认 LOGGER_LEVEL_DEBUG，即全部编译进来）
+ * @details 低于该级别的 Logger::debug()、LOG_DEBUG、lg::debug 与 log_debug(...) 调用
+ *          编译为空操作：不构造 LogStream，宏形式连参数也不求值，开启优化后不留下代码和字符串。
+ *          运行期的 setLevel() 只能在此基础上进一步提高级别
+ */
+#ifndef LOGGER_ACTIVE_LEVEL
+#define LOGGER_ACTIVE_LEVEL LOGGER_LEVEL_DEBUG
+#endif
+
+/**
+ * @brief 该级别的日志调用是否被编译进来
+ */
+constexpr bool logLevelCompiled(LogLevel level) {
+    return static_cast<int>(level) >= LOGGER_ACTIVE_LEVEL;
+}
+
 /**
  * @brief 将日志级别转换为字符串
  * @param level 日志级别
@@ -66,256 +141,5974 @@ inline const char* logLevelToColorCode(LogLevel level) {
         case ERROR:   return "\033[31m"; // 红色
         default:      return "";         // 无颜色
     }
-}
+}
+
+// 前置声明
+class LogStream;
+template <typename... Args> class LogFormatString;
+
+/**
+ * @brief 编译期被剔除级别的空日志流
+ * @details Logger::debug() 等在级别低于 LOGGER_ACTIVE_LEVEL 时返回本类型，
+ *          所有输出运算都是空的内联函数，优化后整条调用消失
+ */
+class LogNullStream {
+public:
+    template <typename T>
+    constexpr const LogNullStream& operator<<(const T&) const noexcept { return *this; }
+
+    // 格式字符串仍在编译期检查，保证剔除级别前后的代码同样合法
+    template <typename... Args>
+    constexpr const LogNullStream& format(const LogFormatString<std::type_identity_t<Args>...>&,
+                                          const Args&...) const noexcept { return *this; }
+};
+
+/**
+ * @brief 级别 Level 的日志调用返回的流类型
+ * @details 被剔除的级别只是把流换成 LogNullStream，参数表达式仍按 C++ 规则求值：
+ *          Logger::debug() << expensive()、lg::debug << expensive() 与 log_debug(expensive())
+ *          都会调用 expensive()，只有 LOG_DEBUG / LOG_DEBUGF 等宏形式完全不求值参数
+ */
+template <LogLevel Level>
+using LogStreamFor = std::conditional_t<logLevelCompiled(Level), LogStream, LogNullStream>;
+
+/**
+ * @brief 标准流操纵符包装类
+ * @details 用于支持 endl、flush 等流操纵符
+ */
+class StdManipulator {
+public:
+    enum Type {
+        Endl,   ///< 换行符
+        Flush,  ///< 刷新（仅换行，实际刷新在析构时完成）
+        None    ///< 无操作
+    };
+
+    constexpr StdManipulator(Type type = None) : type_(type) {}
+
+    constexpr Type getType() const { return type_; }
+
+private:
+    Type type_;
+};
+
+/**
+ * @brief 全局 endl 操纵符
+ * @details 用法：Logger::info() << "message" << ::endl;
+ */
+constexpr StdManipulator endl(StdManipulator::Endl);
+
+/**
+ * @brief 全局 flush 操纵符
+ * @details 用法：Logger::info() << "message" << ::flush;
+ */
+constexpr StdManipulator flush(StdManipulator::Flush);
+
+/**
+ * @brief 时间戳精度（日志行中秒之后的小数位数）
+ */
+enum class TimePrecision {
+    Seconds,       ///< YYYY-MM-DD HH:MM:SS
+    Milliseconds,  ///< YYYY-MM-DD HH:MM:SS.mmm
+    Microseconds,  ///< YYYY-MM-DD HH:MM:SS.uuuuuu
+    Nanoseconds    ///< YYYY-MM-DD HH:MM:SS.nnnnnnnnn
+};
+
+/**
+ * @brief 调用点时间来源
+ */
+enum class ClockSource {
+    Realtime,  ///< 调用点读取 CLOCK_REALTIME
+    Tsc        ///< 调用点只读取周期计数器，写出时换算为墙上时间（见 LogTickClock）
+};
+
+/**
+ * @brief 调用点时间戳
+ * @details ticks 为 0 时 seconds/nanos 即墙上时间；
+ *          否则为 LogTickClock 的原始计数，seconds/nanos 在写出时换算填入
+ */
+struct LogTimestamp {
+    std::time_t seconds;  ///< 自 Epoch 起的秒数
+    uint32_t nanos;       ///< 秒内的纳秒数 [0, 1e9)
+    uint64_t ticks;       ///< 原始周期计数（0 表示未使用）
+};
+
+/**
+ * @brief 墙上时钟读取
+ */
+struct LogClock {
+    /**
+     * @brief 读取当前墙上时钟（纳秒分辨率）
+     */
+    static LogTimestamp now() {
+        #ifdef _WIN32
+        const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        return LogTimestamp{static_cast<std::time_t>(ns / 1000000000),
+                            static_cast<uint32_t>(ns % 1000000000), 0};
+        #else
+        timespec ts;
+        clock_gettime(CLOCK_REALTIME, &ts);
+        return LogTimestamp{ts.tv_sec, static_cast<uint32_t>(ts.tv_nsec), 0};
+        #endif
+    }
+
+    /**
+     * @brief 当前墙上时钟的纳秒数
+     */
+    static int64_t nowNanos() {
+        const LogTimestamp t = now();
+        return static_cast<int64_t>(t.seconds) * 1000000000 + t.nanos;
+    }
+};
+
+/**
+ * @brief 周期计数器时钟
+ * @details 调用点只读取 rdtsc（需要 invariant TSC；否则退回 CLOCK_MONOTONIC_RAW 纳秒数），
+ *          开销只有几纳秒。写出线程用 toWall() 按校准参数换算为墙上时间：
+ *          校准参数为一对同时采样的 (ticks, 墙上纳秒) 锚点和每 tick 纳秒数，
+ *          由换算方每隔 RECALIBRATE_INTERVAL 重新采样锚点并修正速率，以跟随 NTP 调整。
+ *          参数通过顺序锁发布，读取方无锁
+ */
+class LogTickClock {
+public:
+    static constexpr int64_t RECALIBRATE_INTERVAL_NS = 1000000000; ///< 重新校准周期（1 秒）
+
+    LogTickClock()
+        : seq_(0), anchorTicks_(0), anchorNanos_(0), nsPerTick_(1.0) {}
+
+    /**
+     * @brief 读取原始计数
+     */
+    static uint64_t ticks() {
+        #ifdef LOGGER_HAS_RDTSC
+        if (useTsc()) {
+            return __rdtsc();
+        }
+        #endif
+        #ifdef _WIN32
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+        #else
+        timespec ts;
+        #ifdef CLOCK_MONOTONIC_RAW
+        clock_gettime(CLOCK_MONOTONIC_RAW, &ts);
+        #else
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        #endif
+        return static_cast<uint64_t>(ts.tv_sec) * 1000000000 + static_cast<uint64_t>(ts.tv_nsec);
+        #endif
+    }
+
+    /**
+     * @brief 是否使用 rdtsc（CPU 支持 invariant TSC）
+     */
+    static bool useTsc() {
+        #ifdef LOGGER_HAS_RDTSC
+        static const bool invariant = [] {
+            #ifdef _MSC_VER
+            int regs[4];
+            __cpuid(regs, 0x80000000);
+            if (static_cast<unsigned>(regs[0]) < 0x80000007) return false;
+            __cpuid(regs, 0x80000007);
+            return (regs[3] & (1 << 8)) != 0;
+            #else
+            unsigned eax = 0, ebx = 0, ecx = 0, edx = 0;
+            if (__get_cpuid_max(0x80000000, nullptr) < 0x80000007) return false;
+            if (!__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx)) return false;
+            return (edx & (1u << 8)) != 0;
+            #endif
+        }();
+        return invariant;
+        #else
+        return false;
+        #endif
+    }
+
+    /**
+     * @brief 初始校准：间隔约 10ms 采样两个锚点估计 tick 速率
+     */
+    void calibrate() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        uint64_t ticks0;
+        int64_t nanos0;
+        sample(ticks0, nanos0);
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        uint64_t ticks1;
+        int64_t nanos1;
+        sample(ticks1, nanos1);
+
+        double rate = 1.0;
+        if (ticks1 > ticks0 && nanos1 > nanos0) {
+            rate = static_cast<double>(nanos1 - nanos0) / static_cast<double>(ticks1 - ticks0);
+        }
+        publish(ticks1, nanos1, rate);
+    }
+
+    /**
+     * @brief 把原始计数换算为墙上时间，锚点过期时顺带重新校准
+     */
+    LogTimestamp toWall(uint64_t ticks) {
+        uint64_t anchorTicks;
+        int64_t anchorNanos;
+        double nsPerTick;
+        load(anchorTicks, anchorNanos, nsPerTick);
+
+        const double delta = (static_cast<double>(static_cast<int64_t>(ticks - anchorTicks))) * nsPerTick;
+        if (delta > static_cast<double>(RECALIBRATE_INTERVAL_NS)) {
+            recalibrate();
+        }
+
+        const int64_t nanos = anchorNanos + static_cast<int64_t>(delta);
+        return LogTimestamp{static_cast<std::time_t>(nanos / 1000000000),
+                            static_cast<uint32_t>(nanos % 1000000000), 0};
+    }
+
+private:
+    /**
+     * @brief 采样一对 (ticks, 墙上纳秒)，ticks 取墙上时钟读取前后的中点
+     */
+    static void sample(uint64_t& ticks, int64_t& nanos) {
+        const uint64_t before = LogTickClock::ticks();
+        nanos = LogClock::nowNanos();
+        const uint64_t after = LogTickClock::ticks();
+        ticks = before + (after - before) / 2;
+    }
+
+    /**
+     * @brief 以新锚点修正速率（墙上时钟发生跳变时只移动锚点）
+     */
+    void recalibrate() {
+        std::unique_lock<std::mutex> lock(mutex_, std::try_to_lock);
+        if (!lock.owns_lock()) return; // 其他线程正在校准
+
+        uint64_t anchorTicks;
+        int64_t anchorNanos;
+        double nsPerTick;
+        load(anchorTicks, anchorNanos, nsPerTick);
+
+        uint64_t ticks;
+        int64_t nanos;
+        sample(ticks, nanos);
+        if (ticks <= anchorTicks) return;
+
+        const double measured = static_cast<double>(nanos - anchorNanos) /
+                                static_cast<double>(ticks - anchorTicks);
+        if (measured > nsPerTick * 0.99 && measured < nsPerTick * 1.01) {
+            nsPerTick = measured;
+        }
+        publish(ticks, nanos, nsPerTick);
+    }
+
+    /**
+     * @brief 顺序锁写端（持有 mutex_ 时调用）
+     */
+    void publish(uint64_t ticks, int64_t nanos, double nsPerTick) {
+        const uint32_t seq = seq_.load(std::memory_order_relaxed);
+        seq_.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        anchorTicks_.store(ticks, std::memory_order_relaxed);
+        anchorNanos_.store(nanos, std::memory_order_relaxed);
+        nsPerTick_.store(nsPerTick, std::memory_order_relaxed);
+        seq_.store(seq + 2, std::memory_order_release);
+    }
+
+    /**
+     * @brief 顺序锁读端
+     */
+    void load(uint64_t& ticks, int64_t& nanos, double& nsPerTick) const {
+        for (;;) {
+            const uint32_t seq = seq_.load(std::memory_order_acquire);
+            if (seq & 1) continue;
+            ticks = anchorTicks_.load(std::memory_order_relaxed);
+            nanos = anchorNanos_.load(std::memory_order_relaxed);
+            nsPerTick = nsPerTick_.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (seq_.load(std::memory_order_relaxed) == seq) return;
+        }
+    }
+
+    std::mutex mutex_;                  ///< 串行化校准
+    std::atomic<uint32_t> seq_;         ///< 顺序锁序号（奇数表示正在更新）
+    std::atomic<uint64_t> anchorTicks_; ///< 锚点计数
+    std::atomic<int64_t> anchorNanos_;  ///< 锚点对应的墙上纳秒数
+    std::atomic<double> nsPerTick_;     ///< 每 tick 的纳秒数
+};
+
+/**
+ * @brief 日志时间使用的时区
+ */
+enum class TimeZoneMode {
+    Local,        ///< 本地时间，每次换算调用 localtime_r（默认）
+    CachedLocal,  ///< 本地时间，缓存当前 UTC 偏移，只在夏令时切换点重新计算
+    Utc           ///< UTC 时间，日志行时间戳以 Z 结尾
+};
+
+/**
+ * @brief 纪元秒与日期时间的换算
+ * @details localtime_r 在 glibc 中要取全局时区锁，并可能重新检查 TZ。
+ *          CachedLocal 模式缓存一段偏移不变的区间 [from, until)，区间内只做整数运算，
+ *          越出区间（夏令时切换）时才按天探测并二分定位到下一个切换秒；
+ *          进程运行中修改 TZ 不会被察觉。Utc 模式偏移恒为 0。
+ *          非线程安全：每个渲染器和文件 sink 各自持有一个
+ */
+class LogTimeZone {
+public:
+    /**
+     * @brief 日期时间各字段
+     */
+    struct Civil {
+        int year;          ///< 年
+        unsigned month;    ///< 月 [1, 12]
+        unsigned day;      ///< 日 [1, 31]
+        unsigned hour;     ///< 时 [0, 23]
+        unsigned minute;   ///< 分 [0, 59]
+        unsigned second;   ///< 秒 [0, 59]
+    };
+
+    explicit LogTimeZone(TimeZoneMode mode = TimeZoneMode::Local)
+        : mode_(mode), cachedFrom_(0), cachedUntil_(0), cachedOffset_(0) {}
+
+    /**
+     * @brief 切换时区模式（丢弃缓存的偏移）
+     */
+    void setMode(TimeZoneMode mode) {
+        mode_ = mode;
+        cachedFrom_ = 0;
+        cachedUntil_ = 0;
+    }
+
+    TimeZoneMode mode() const { return mode_; }  ///< 当前时区模式
+
+    /**
+     * @brief 时刻 t 的本地时间相对 UTC 的偏移（秒）
+     */
+    long offsetAt(std::time_t t) {
+        switch (mode_) {
+        case TimeZoneMode::Utc:
+            return 0;
+        case TimeZoneMode::CachedLocal:
+            if (t < cachedFrom_ || t >= cachedUntil_) refresh(t);
+            return cachedOffset_;
+        default:
+            return systemOffset(t);
+        }
+    }
+
+    /**
+     * @brief 纪元秒换算为日期时间
+     */
+    Civil toCivil(std::time_t t) {
+        return civilOf(static_cast<int64_t>(t) + offsetAt(t));
+    }
+
+    /**
+     * @brief 日期时间换算为纪元秒（日、时超出范围时自动进位，如 day + 1 表示次日）
+     */
+    std::time_t fromCivil(int year, unsigned month, unsigned day,
+                          unsigned hour = 0, unsigned minute = 0, unsigned second = 0) {
+        const int64_t local = daysFromCivil(year, month, day) * 86400 +
+                              hour * 3600 + minute * 60 + second;
+        // 先按该本地时刻附近的偏移估算，再用估算结果处的偏移修正一次
+        const std::time_t guess = static_cast<std::time_t>(local - offsetAt(static_cast<std::time_t>(local)));
+        return static_cast<std::time_t>(local - offsetAt(guess));
+    }
+
+    /**
+     * @brief 本地秒数（纪元秒加偏移）拆分为日期时间
+     */
+    static Civil civilOf(int64_t local) {
+        int64_t days = local / 86400;
+        int64_t secs = local % 86400;
+        if (secs < 0) {
+            secs += 86400;
+            days -= 1;
+        }
+        Civil c;
+        civilFromDays(days, c.year, c.month, c.day);
+        c.hour = static_cast<unsigned>(secs / 3600);
+        c.minute = static_cast<unsigned>(secs / 60 % 60);
+        c.second = static_cast<unsigned>(secs % 60);
+        return c;
+    }
+
+    /**
+     * @brief 公历日期距 1970-01-01 的天数
+     */
+    static int64_t daysFromCivil(int year, unsigned month, unsigned day) {
+        const int64_t y = static_cast<int64_t>(year) - (month <= 2 ? 1 : 0);
+        const int64_t era = (y >= 0 ? y : y - 399) / 400;
+        const int64_t yoe = y - era * 400;
+        const int64_t doy = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+        const int64_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+        return era * 146097 + doe - 719468;
+    }
+
+    /**
+     * @brief 距 1970-01-01 的天数换算为公历日期
+     */
+    static void civilFromDays(int64_t days, int& year, unsigned& month, unsigned& day) {
+        days += 719468;
+        const int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+        const int64_t doe = days - era * 146097;
+        const int64_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+        const int64_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+        const int64_t mp = (5 * doy + 2) / 153;
+        day = static_cast<unsigned>(doy - (153 * mp + 2) / 5 + 1);
+        month = static_cast<unsigned>(mp < 10 ? mp + 3 : mp - 9);
+        year = static_cast<int>(yoe + era * 400 + (month <= 2 ? 1 : 0));
+    }
+
+private:
+    static constexpr std::time_t PROBE_STEP = 86400;        ///< 探测切换点的步长（1 天）
+    static constexpr std::time_t PROBE_RANGE = 400 * 86400; ///< 单向探测范围
+
+    /**
+     * @brief 通过 localtime_r 计算 t 时刻的偏移
+     */
+    static long systemOffset(std::time_t t) {
+        std::tm tm_buf;
+        #ifdef _WIN32
+        localtime_s(&tm_buf, &t);
+        #else
+        localtime_r(&t, &tm_buf);
+        #endif
+        const int64_t local = daysFromCivil(tm_buf.tm_year + 1900, static_cast<unsigned>(tm_buf.tm_mon + 1),
+                                            static_cast<unsigned>(tm_buf.tm_mday)) * 86400 +
+                              tm_buf.tm_hour * 3600 + tm_buf.tm_min * 60 + tm_buf.tm_sec;
+        return static_cast<long>(local - static_cast<int64_t>(t));
+    }
+
+    /**
+     * @brief 重新计算 t 所在的偏移不变区间
+     */
+    void refresh(std::time_t t) {
+        cachedOffset_ = systemOffset(t);
+
+        // 向后按天探测，找到偏移变化的那一天后二分到秒
+        cachedUntil_ = t + PROBE_RANGE;
+        for (std::time_t probe = t + PROBE_STEP; probe <= t + PROBE_RANGE; probe += PROBE_STEP) {
+            if (systemOffset(probe) != cachedOffset_) {
+                std::time_t same = probe - PROBE_STEP;
+                std::time_t changed = probe;
+                while (changed - same > 1) {
+                    const std::time_t mid = same + (changed - same) / 2;
+                    if (systemOffset(mid) == cachedOffset_) {
+                        same = mid;
+                    } else {
+                        changed = mid;
+                    }
+                }
+                cachedUntil_ = changed;
+                break;
+            }
+        }
+
+        // 向前同样探测，记录乱序到达的稍早时间不会反复触发重算
+        cachedFrom_ = t - PROBE_RANGE;
+        for (std::time_t probe = t - PROBE_STEP; probe >= t - PROBE_RANGE; probe -= PROBE_STEP) {
+            if (systemOffset(probe) != cachedOffset_) {
+                std::time_t changed = probe;
+                std::time_t same = probe + PROBE_STEP;
+                while (same - changed > 1) {
+                    const std::time_t mid = changed + (same - changed) / 2;
+                    if (systemOffset(mid) == cachedOffset_) {
+                        same = mid;
+                    } else {
+                        changed = mid;
+                    }
+                }
+                cachedFrom_ = same;
+                break;
+            }
+        }
+    }
+
+    TimeZoneMode mode_;          ///< 时区模式
+    std::time_t cachedFrom_;     ///< 缓存偏移的有效区间起点（含）
+    std::time_t cachedUntil_;    ///< 缓存偏移的有效区间终点（不含）
+    long cachedOffset_;          ///< 缓存的 UTC 偏移（秒）
+};
+
+/**
+ * @brief 路径中的文件名部分（编译期与运行期均可用）
+ */
+constexpr const char* logBasename(const char* path) {
+    const char* base = path;
+    for (const char* p = path; *p; ++p) {
+        if (*p == '/' || *p == '\\') base = p + 1;
+    }
+    return base;
+}
+
+class LogSitePrefix;
+
+/**
+ * @brief 调用点描述符
+ * @details 由 LOGGER_SITE 在编译期为每个调用点生成一个静态常量，记录只携带指向它的指针；
+ *          file 为编译期截取的文件名，function 为所在函数（去掉宏内 lambda 的后缀），
+ *          format 为格式化接口的格式串（流式调用为 nullptr），
+ *          prefix 指向同一调用点的行前缀缓存（描述符本身是常量，缓存单独存放）
+ */
+struct LogSite {
+    LogLevel level;             ///< 日志级别
+    int line;                   ///< 源代码行号
+    const char* file;           ///< 源文件名（不含目录）
+    std::string_view function;  ///< 所在函数
+    const char* format;         ///< 格式串提示（流式调用为 nullptr）
+    LogSitePrefix* prefix;      ///< 行前缀缓存（可能为空）
+
+    /**
+     * @brief 由 source_location 在编译期构造描述符
+     */
+    static consteval LogSite make(LogLevel level, const std::source_location& loc,
+                                  const char* format = nullptr, LogSitePrefix* prefix = nullptr) {
+        return LogSite{level, static_cast<int>(loc.line()), logBasename(loc.file_name()),
+                       functionName(loc.function_name()), format, prefix};
+    }
+
+    /**
+     * @brief 去掉 LOGGER_SITE 内 lambda 带来的修饰，只留所在函数
+     * @details GCC 写作 "f(int)::<lambda()>"；Clang 写作
+     *          "const LogSite &f(int)::(anonymous class)::operator()() const"
+     *          或 "...::(lambda at file:line:col)::operator()() const"。其他写法原样保留
+     */
+    static constexpr std::string_view functionName(const char* name) {
+        constexpr std::string_view LAMBDA_SUFFIX = "::<lambda()>";
+        constexpr std::string_view CLANG_LAMBDAS[] = {"::(anonymous class)::operator()", "::(lambda at "};
+        constexpr std::string_view RETURN_TYPE = "const LogSite &";
+        std::string_view view(name);
+        if (view.ends_with(LAMBDA_SUFFIX)) {
+            view.remove_suffix(LAMBDA_SUFFIX.size());
+            return view;
+        }
+        for (std::string_view lambda : CLANG_LAMBDAS) {
+            // 宏内的 lambda 是最内层，取最后一次出现
+            const size_t pos = view.rfind(lambda);
+            if (pos == std::string_view::npos) continue;
+            view = view.substr(0, pos);
+            if (view.starts_with(RETURN_TYPE)) view.remove_prefix(RETURN_TYPE.size());
+            break;
+        }
+        return view;
+    }
+};
+
+/**
+ * @brief 调用点的行前缀缓存
+ * @details " [LEVEL] file:line - " 对同一调用点的每条记录都相同，首次渲染时生成一次，
+ *          同时生成一份级别带颜色的版本供控制台使用；之后每条记录只需整段复制。
+ *          首个渲染该调用点的线程以 CAS 占用并写入，完成后以 release 发布；
+ *          发布前其他线程照常逐段渲染。前缀超过 CAPACITY 时不缓存。
+ *          构造函数为 constexpr，静态实例在编译期完成初始化，没有构造开销
+ */
+class LogSitePrefix {
+public:
+    static constexpr size_t CAPACITY = 160; ///< 两份前缀合计的最大长度
+    static constexpr size_t LEVEL_POS = 2;  ///< 级别文本在前缀中的位置（" [" 之后）
+
+    constexpr LogSitePrefix()
+        : state_(EMPTY), plainLength_(0), coloredLength_(0), levelLength_(0), text_{} {}
+
+    LogSitePrefix(const LogSitePrefix&) = delete;
+    LogSitePrefix& operator=(const LogSitePrefix&) = delete;
+
+    /**
+     * @brief 前缀是否已可用
+     */
+    bool ready() const {
+        return state_.load(std::memory_order_acquire) == READY;
+    }
+
+    /**
+     * @brief 确保前缀已生成：尚未生成时由当前线程生成
+     * @return 前缀可用时返回 true；其他线程正在生成或前缀过长时返回 false
+     */
+    bool ensure(const LogSite& site) {
+        uint8_t state = state_.load(std::memory_order_acquire);
+        if (state == READY) return true;
+        if (state != EMPTY || !state_.compare_exchange_strong(state, BUILDING, std::memory_order_acquire)) {
+            return false;
+        }
+        const bool fits = render(site);
+        state_.store(fits ? READY : UNCACHEABLE, std::memory_order_release);
+        return fits;
+    }
+
+    std::string_view plain() const { return std::string_view(text_, plainLength_); }  ///< 不带颜色的前缀
+    std::string_view colored() const {                                                ///< 级别带颜色的前缀
+        return std::string_view(text_ + plainLength_, coloredLength_);
+    }
+    size_t levelLength() const { return levelLength_; }  ///< 级别文本长度
+
+private:
+    static constexpr uint8_t EMPTY = 0;        ///< 尚未生成
+    static constexpr uint8_t BUILDING = 1;     ///< 某个线程正在生成
+    static constexpr uint8_t READY = 2;        ///< 已发布
+    static constexpr uint8_t UNCACHEABLE = 3;  ///< 超过容量，不再尝试
+
+    /**
+     * @brief 依次写入两份前缀（调用方已独占）
+     */
+    bool render(const LogSite& site) {
+        const char* level = logLevelToString(site.level);
+        const int plain = std::snprintf(text_, CAPACITY, " [%s] %s:%d - ", level, site.file, site.line);
+        if (plain < 0 || static_cast<size_t>(plain) >= CAPACITY) return false;
+        const int colored = std::snprintf(text_ + plain, CAPACITY - plain, " [%s%s\033[0m] %s:%d - ",
+                                          logLevelToColorCode(site.level), level, site.file, site.line);
+        if (colored < 0 || static_cast<size_t>(plain + colored) >= CAPACITY) return false;
+        plainLength_ = static_cast<uint16_t>(plain);
+        coloredLength_ = static_cast<uint16_t>(colored);
+        levelLength_ = static_cast<uint16_t>(std::strlen(level));
+        return true;
+    }
+
+    std::atomic<uint8_t> state_;  ///< 生成状态
+    uint16_t plainLength_;        ///< 不带颜色的前缀长度
+    uint16_t coloredLength_;      ///< 带颜色的前缀长度
+    uint16_t levelLength_;        ///< 级别文本长度
+    char text_[CAPACITY];         ///< 两份前缀依次存放
+};
+
+/**
+ * @brief 当前调用点的静态描述符
+ * @details 每处展开生成一个 lambda，其中的 static constexpr 对象即该调用点的描述符，
+ *          旁边的静态 LogSitePrefix 为它的行前缀缓存
+ */
+#define LOGGER_SITE(level, format) \
+    ([]() -> const LogSite& { \
+        static LogSitePrefix prefix; \
+        static constexpr LogSite site = LogSite::make(level, std::source_location::current(), format, &prefix); \
+        return site; \
+    }())
+
+/**
+ * @brief 日志记录视图
+ * @details 由调用线程构造，message 可能指向栈缓冲区或环形缓冲区中的内存，
+ *          仅在一次写出调用期间有效
+ */
+struct LogRecord {
+    LogLevel level;       ///< 日志级别
+    int line;             ///< 源代码行号
+    const char* file;     ///< 源文件名
+    std::time_t time;     ///< 记录产生时间（秒）
+    uint32_t nanos;       ///< 记录产生时间的秒内纳秒数
+    uint64_t ticks;       ///< 非 0 时为调用点的原始周期计数，time/nanos 待写出时换算
+    uint64_t sequence;    ///< 全局序号（0 表示未启用）
+    const char* message;  ///< 消息内容（不保证以 '\0' 结尾）
+    size_t length;        ///< 消息长度
+    bool encoded;         ///< message 是否为延迟格式化的参数编码（见 LogArgCodec）
+    const LogSite* site = nullptr; ///< 调用点描述符（宏调用时非空，file/line 与之一致）
+};
+
+/**
+ * @brief 日志参数编解码器（延迟格式化）
+ * @details 延迟格式化模式下，LogStream 不在调用线程做文本转换，
+ *          而是为每个参数写入 1 字节类型标记和原始字节；
+ *          后台线程写出时再调用 decode() 转换为与同步模式完全一致的文本
+ */
+class LogArgCodec {
+public:
+    /**
+     * @brief 参数类型标记
+     */
+    enum Tag : uint8_t {
+        Bool,     ///< 1 字节 bool
+        Char,     ///< 1 字节字符
+        Int,      ///< int64_t
+        UInt,     ///< uint64_t
+        Double,   ///< double
+        Pointer,  ///< const void*
+        String    ///< uint32_t 长度 + 字符字节
+    };
+
+    /**
+     * @brief 编码一个算术类型参数
+     * @param dst 目标缓冲区
+     * @param capacity 剩余可用字节
+     * @return 写入的字节数，空间不足时为 0
+     */
+    template <typename T> requires std::is_arithmetic_v<T>
+    static size_t encode(char* dst, size_t capacity, T val) {
+        if constexpr (std::is_same_v<T, bool>) {
+            return put(dst, capacity, Bool, static_cast<uint8_t>(val));
+        } else if constexpr (std::is_same_v<T, char>) {
+            return put(dst, capacity, Char, val);
+        } else if constexpr (std::is_floating_point_v<T>) {
+            return put(dst, capacity, Double, static_cast<double>(val));
+        } else if constexpr (std::is_signed_v<T>) {
+            return put(dst, capacity, Int, static_cast<int64_t>(val));
+        } else {
+            return put(dst, capacity, UInt, static_cast<uint64_t>(val));
+        }
+    }
+
+    /**
+     * @brief 编码指针参数
+     */
+    static size_t encode(char* dst, size_t capacity, const void* val) {
+        return put(dst, capacity, Pointer, val);
+    }
+
+    /**
+     * @brief 编码字符串参数，空间不足时截断
+     */
+    static size_t encode(char* dst, size_t capacity, const char* str, size_t length) {
+        if (capacity <= STRING_HEADER) return 0;
+        if (length > capacity - STRING_HEADER) length = capacity - STRING_HEADER;
+
+        encodeStringHeader(dst, length);
+        std::memcpy(dst + STRING_HEADER, str, length);
+        return STRING_HEADER + length;
+    }
+
+    /// 字符串参数的头部字节数（类型标记 + uint32_t 长度）
+    static constexpr size_t STRING_HEADER = 1 + sizeof(uint32_t);
+
+    /**
+     * @brief 写入字符串参数的头部，负载由调用方直接写在 dst + STRING_HEADER 处
+     */
+    static void encodeStringHeader(char* dst, size_t length) {
+        const uint32_t len32 = static_cast<uint32_t>(length);
+        dst[0] = static_cast<char>(String);
+        std::memcpy(dst + 1, &len32, sizeof(len32));
+    }
+
+    /**
+     * @brief 将编码后的参数转换为文本
+     * @param data 编码数据
+     * @param length 编码数据长度
+     * @param out 输出字符串（追加写入）
+     */
+    static void decode(const char* data, size_t length, std::string& out) {
+        const char* p = data;
+        const char* end = data + length;
+        char tmp[32];
+
+        while (p < end) {
+            const Tag tag = static_cast<Tag>(*p++);
+            switch (tag) {
+                case Bool:
+                    out.append(get<uint8_t>(p) ? "true" : "false");
+                    break;
+                case Char:
+                    out.push_back(get<char>(p));
+                    break;
+                case Int: {
+                    auto res = std::to_chars(tmp, tmp + sizeof(tmp), get<int64_t>(p));
+                    out.append(tmp, res.ptr);
+                    break;
+                }
+                case UInt: {
+                    auto res = std::to_chars(tmp, tmp + sizeof(tmp), get<uint64_t>(p));
+                    out.append(tmp, res.ptr);
+                    break;
+                }
+                case Double:
+                    appendFormatted(out, tmp, snprintf(tmp, sizeof(tmp), "%.4f", get<double>(p)));
+                    break;
+                case Pointer:
+                    appendFormatted(out, tmp, snprintf(tmp, sizeof(tmp), "%p", get<const void*>(p)));
+                    break;
+                case String: {
+                    const uint32_t len = get<uint32_t>(p);
+                    out.append(p, len);
+                    p += len;
+                    break;
+                }
+                default:
+                    return; // 数据损坏，放弃剩余部分
+            }
+        }
+    }
+
+private:
+    template <typename V>
+    static size_t put(char* dst, size_t capacity, Tag tag, V val) {
+        if (capacity < 1 + sizeof(V)) return 0;
+        dst[0] = static_cast<char>(tag);
+        std::memcpy(dst + 1, &val, sizeof(V));
+        return 1 + sizeof(V);
+    }
+
+    template <typename V>
+    static V get(const char*& p) {
+        V val;
+        std::memcpy(&val, p, sizeof(V));
+        p += sizeof(V);
+        return val;
+    }
+
+    // 与 LogStream 保持一致：snprintf 截断时只保留缓冲区内的部分
+    static void appendFormatted(std::string& out, const char* tmp, int len) {
+        if (len <= 0) return;
+        out.append(tmp, std::min<size_t>(static_cast<size_t>(len), 31));
+    }
+};
+
+/**
+ * @brief 格式化接口中参数的类别，决定允许的格式规格
+ */
+enum class LogFormatKind : uint8_t {
+    Bool,     ///< bool
+    Char,     ///< char
+    Int,      ///< 其他整数类型
+    Float,    ///< 浮点类型
+    String,   ///< 可转换为 std::string_view 的类型
+    Pointer   ///< 指针与 nullptr
+};
+
+/**
+ * @brief 求参数类型 T 的格式化类别，不支持的类型在编译期报错
+ */
+template <typename T>
+consteval LogFormatKind logFormatKindOf() {
+    using U = std::remove_cvref_t<T>;
+    if constexpr (std::is_same_v<U, bool>) {
+        return LogFormatKind::Bool;
+    } else if constexpr (std::is_same_v<U, char>) {
+        return LogFormatKind::Char;
+    } else if constexpr (std::is_integral_v<U>) {
+        return LogFormatKind::Int;
+    } else if constexpr (std::is_floating_point_v<U>) {
+        return LogFormatKind::Float;
+    } else if constexpr (std::is_null_pointer_v<U>) {
+        return LogFormatKind::Pointer;
+    } else if constexpr (std::is_convertible_v<const U&, std::string_view>) {
+        return LogFormatKind::String;
+    } else if constexpr (std::is_pointer_v<U>) {
+        return LogFormatKind::Pointer;
+    } else {
+        static_assert(sizeof(U) == 0, "Logger 格式化接口不支持该参数类型");
+    }
+}
+
+/**
+ * @brief 单个 {} 占位符解析后的格式规格
+ * @details 语法为 {[:[[填充]对齐][0][宽度][.精度][类型]]}，是 std::format 规格的子集：
+ *          对齐 < > ^，类型 d x X b o（整数）、c（字符）、f e g（浮点）、s（字符串/bool）、p（指针）
+ */
+struct LogFormatSpec {
+    char fill = ' ';         ///< 填充字符
+    char align = 0;          ///< 对齐方式，0 表示按类别默认（数值右对齐，其余左对齐）
+    bool zero = false;       ///< 数值补零（位于符号之后）
+    uint16_t width = 0;      ///< 最小宽度
+    int16_t precision = -1;  ///< 精度，-1 表示未指定
+    char type = 0;           ///< 类型字符，0 表示默认
+};
+
+/**
+ * @brief 编译期检查的格式字符串
+ * @tparam Args 与之匹配的参数类型
+ * @details 由字符串字面量隐式构造（consteval），构造时解析全部占位符并按参数类型检查规格，
+ *          占位符数量与参数不符或规格不合法时编译失败；默认实参同时捕获调用方的文件、行号与函数。
+ *          对象较大（每个参数一项规格），各接口都按 const 引用传递
+ */
+template <typename... Args>
+class LogFormatString {
+public:
+    template <typename S> requires std::is_convertible_v<const S&, std::string_view>
+    consteval LogFormatString(const S& text, std::source_location loc = std::source_location::current())
+        : text_(text), file_(logBasename(loc.file_name())), line_(static_cast<int>(loc.line())),
+          function_(LogSite::functionName(loc.function_name())) {
+        if (const char* message = parse(text_, layout_)) {
+            invalidFormat(message);
+        }
+    }
+
+    /**
+     * @brief 检查格式字符串，返回错误描述，合法时返回 nullptr（可用于 static_assert）
+     */
+    static constexpr const char* check(std::string_view text) {
+        Layout layout;
+        return parse(text, layout);
+    }
+
+    std::string_view text() const noexcept { return text_; }
+    const char* file() const noexcept { return file_; }
+    int line() const noexcept { return line_; }
+    std::string_view function() const noexcept { return function_; }
+    const LogFormatSpec& spec(size_t index) const noexcept { return layout_.specs[index]; }
+    size_t placeholderBegin(size_t index) const noexcept { return layout_.begin[index]; }
+    size_t placeholderEnd(size_t index) const noexcept { return layout_.end[index]; }
+    bool escaped() const noexcept { return layout_.escaped; }
+
+private:
+    /**
+     * @brief 解析结果：各占位符的规格与位置，格式化时字面文本按位置整段复制
+     */
+    struct Layout {
+        std::array<LogFormatSpec, sizeof...(Args)> specs{};
+        std::array<uint32_t, sizeof...(Args)> begin{}; ///< 占位符 '{' 的位置
+        std::array<uint32_t, sizeof...(Args)> end{};   ///< 占位符 '}' 之后的位置
+        bool escaped = false;                          ///< 字面文本中是否有 {{ 或 }}
+    };
+
+    static constexpr std::array<LogFormatKind, sizeof...(Args)> kinds_{logFormatKindOf<Args>()...};
+
+    // 非 constexpr 函数：常量求值中调用即编译失败，具体原因可用 check() 得到
+    static void invalidFormat(const char* message) { (void)message; }
+
+    static constexpr bool isDigit(char c) { return c >= '0' && c <= '9'; }
+
+    static constexpr const char* parse(std::string_view text, Layout& layout) {
+        size_t arg = 0;
+        for (size_t i = 0; i < text.size(); ++i) {
+            const char c = text[i];
+            if (c == '}') {
+                if (i + 1 < text.size() && text[i + 1] == '}') { ++i; layout.escaped = true; continue; }
+                return "unmatched '}' in format string";
+            }
+            if (c != '{') continue;
+            if (i + 1 < text.size() && text[i + 1] == '{') { ++i; layout.escaped = true; continue; }
+            if (arg >= sizeof...(Args)) return "more placeholders than arguments";
+
+            LogFormatSpec spec;
+            size_t j = i + 1;
+            if (j < text.size() && text[j] == ':') {
+                ++j;
+                auto isAlign = [](char a) { return a == '<' || a == '>' || a == '^'; };
+                if (j + 1 < text.size() && text[j] != '{' && text[j] != '}' && isAlign(text[j + 1])) {
+                    spec.fill = text[j];
+                    spec.align = text[j + 1];
+                    j += 2;
+                } else if (j < text.size() && isAlign(text[j])) {
+                    spec.align = text[j++];
+                }
+                if (j < text.size() && text[j] == '0') {
+                    spec.zero = true;
+                    ++j;
+                }
+                unsigned width = 0;
+                while (j < text.size() && isDigit(text[j])) {
+                    width = width * 10 + static_cast<unsigned>(text[j++] - '0');
+                    if (width > 255) return "width too large";
+                }
+                spec.width = static_cast<uint16_t>(width);
+                if (j < text.size() && text[j] == '.') {
+                    ++j;
+                    if (j >= text.size() || !isDigit(text[j])) return "missing precision after '.'";
+                    int precision = 0;
+                    while (j < text.size() && isDigit(text[j])) {
+                        precision = precision * 10 + (text[j++] - '0');
+                        if (precision > 255) return "precision too large";
+                    }
+                    spec.precision = static_cast<int16_t>(precision);
+                }
+                if (j < text.size() && text[j] != '}') {
+                    spec.type = text[j++];
+                }
+            }
+            if (j >= text.size() || text[j] != '}') return "invalid format specification";
+            if (const char* message = checkSpec(spec, kinds_[arg])) return message;
+            layout.specs[arg] = spec;
+            layout.begin[arg] = static_cast<uint32_t>(i);
+            layout.end[arg] = static_cast<uint32_t>(j + 1);
+            ++arg;
+            i = j;
+        }
+        if (arg != sizeof...(Args)) return "fewer placeholders than arguments";
+        return nullptr;
+    }
+
+    static constexpr const char* checkSpec(const LogFormatSpec& spec, LogFormatKind kind) {
+        const bool integral = kind == LogFormatKind::Int || kind == LogFormatKind::Char ||
+                              kind == LogFormatKind::Bool;
+        switch (spec.type) {
+            case 0:
+                break;
+            case 'd': case 'x': case 'X': case 'b': case 'o':
+                if (!integral) return "integer presentation type used with a non-integer argument";
+                break;
+            case 'c':
+                if (kind != LogFormatKind::Int && kind != LogFormatKind::Char) {
+                    return "'c' requires an integer or char argument";
+                }
+                break;
+            case 'f': case 'e': case 'g':
+                if (kind != LogFormatKind::Float) return "floating-point presentation type used with a non-float argument";
+                break;
+            case 's':
+                if (kind != LogFormatKind::String && kind != LogFormatKind::Bool) {
+                    return "'s' requires a string or bool argument";
+                }
+                break;
+            case 'p':
+                if (kind != LogFormatKind::Pointer) return "'p' requires a pointer argument";
+                break;
+            default:
+                return "unknown presentation type";
+        }
+        if (spec.precision >= 0 && kind != LogFormatKind::Float && kind != LogFormatKind::String) {
+            return "precision is only allowed for floating-point and string arguments";
+        }
+        const bool numeric = kind == LogFormatKind::Int || kind == LogFormatKind::Float ||
+                             (kind == LogFormatKind::Char && spec.type != 0 && spec.type != 'c') ||
+                             (kind == LogFormatKind::Bool && spec.type != 0 && spec.type != 's');
+        if (spec.zero && !numeric) return "'0' padding is only allowed for numeric output";
+        return nullptr;
+    }
+
+    std::string_view text_;
+    const char* file_;
+    int line_;
+    std::string_view function_;
+    Layout layout_;
+};
+
+/**
+ * @brief 按 LogFormatString 把参数直接写入定长缓冲区
+ * @details 不分配内存、不经过临时字符串；输出超过容量时截断（与 LogStream 一致）
+ */
+class LogFormatter {
+public:
+    /**
+     * @brief 格式化到 [dst, dst + capacity)
+     * @return 写入的字节数（不含结尾 '\0'，也不写入 '\0'）
+     */
+    template <typename... Args>
+    static size_t format(char* dst, size_t capacity, const LogFormatString<Args...>& fmt,
+                         const Args&... args) {
+        Output out{dst, dst + capacity};
+        const std::string_view text = fmt.text();
+        size_t index = 0;
+        if (!fmt.escaped()) {
+            // 占位符位置已在编译期算好，字面文本整段复制
+            size_t pos = 0;
+            ((out.put(text.data() + pos, fmt.placeholderBegin(index) - pos),
+              writeArg(out, fmt.spec(index), args), pos = fmt.placeholderEnd(index++)), ...);
+            out.put(text.data() + pos, text.size() - pos);
+            return static_cast<size_t>(out.pos - dst);
+        }
+        const char* p = text.data();
+        const char* end = p + text.size();
+        ((copyLiteral(out, p, end), writeArg(out, fmt.spec(index++), args)), ...);
+        copyLiteral(out, p, end);
+        return static_cast<size_t>(out.pos - dst);
+    }
+
+private:
+    struct Output {
+        char* pos;
+        char* end;
+
+        void put(const char* data, size_t length) {
+            length = std::min(length, static_cast<size_t>(end - pos));
+            std::memcpy(pos, data, length);
+            pos += length;
+        }
+
+        void fill(char c, size_t count) {
+            count = std::min(count, static_cast<size_t>(end - pos));
+            std::memset(pos, c, count);
+            pos += count;
+        }
+    };
+
+    // 复制到下一个占位符之前的字面文本（处理 {{ 与 }}），并跳过该占位符
+    static void copyLiteral(Output& out, const char*& p, const char* end) {
+        while (p < end) {
+            const char* run = p;
+            while (p < end && *p != '{' && *p != '}') ++p;
+            out.put(run, static_cast<size_t>(p - run));
+            if (p == end) return;
+            if (p + 1 < end && p[1] == *p) {
+                out.put(p, 1);
+                p += 2;
+                continue;
+            }
+            // 编译期已验证格式，此处必为占位符起始
+            while (*p != '}') ++p;
+            ++p;
+            return;
+        }
+    }
+
+    // 按规格输出已转换好的文本，处理宽度、对齐与补零
+    static void writePadded(Output& out, const char* data, size_t length,
+                            const LogFormatSpec& spec, bool numeric) {
+        if (spec.width <= length) {
+            out.put(data, length);
+            return;
+        }
+        const size_t padding = spec.width - length;
+        if (spec.zero && !spec.align && numeric) {
+            const size_t sign = (length > 0 && (data[0] == '-' || data[0] == '+')) ? 1 : 0;
+            out.put(data, sign);
+            out.fill('0', padding);
+            out.put(data + sign, length - sign);
+            return;
+        }
+        const char align = spec.align ? spec.align : (numeric ? '>' : '<');
+        const size_t before = align == '>' ? padding : (align == '^' ? padding / 2 : 0);
+        out.fill(spec.fill, before);
+        out.put(data, length);
+        out.fill(spec.fill, padding - before);
+    }
+
+    template <typename T>
+    static void writeInteger(Output& out, const LogFormatSpec& spec, T val) {
+        char tmp[72];
+        int base = 10;
+        switch (spec.type) {
+            case 'x': case 'X': base = 16; break;
+            case 'b': base = 2; break;
+            case 'o': base = 8; break;
+            default: break;
+        }
+        auto res = std::to_chars(tmp, tmp + sizeof(tmp), val, base);
+        if (spec.type == 'X') {
+            for (char* c = tmp; c < res.ptr; ++c) {
+                if (*c >= 'a' && *c <= 'f') *c = static_cast<char>(*c - 'a' + 'A');
+            }
+        }
+        writePadded(out, tmp, static_cast<size_t>(res.ptr - tmp), spec, true);
+    }
+
+    static void writeArg(Output& out, const LogFormatSpec& spec, bool val) {
+        if (spec.type == 0 || spec.type == 's') {
+            writePadded(out, val ? "true" : "false", val ? 4 : 5, spec, false);
+        } else {
+            writeInteger(out, spec, static_cast<int>(val));
+        }
+    }
+
+    static void writeArg(Output& out, const LogFormatSpec& spec, char val) {
+        if (spec.type == 0 || spec.type == 'c') {
+            writePadded(out, &val, 1, spec, false);
+        } else {
+            writeInteger(out, spec, static_cast<int>(val));
+        }
+    }
+
+    template <typename T> requires (std::is_integral_v<T> && !std::is_same_v<T, bool> &&
+                                    !std::is_same_v<T, char>)
+    static void writeArg(Output& out, const LogFormatSpec& spec, T val) {
+        if (spec.type == 'c') {
+            const char c = static_cast<char>(val);
+            writePadded(out, &c, 1, spec, false);
+        } else {
+            writeInteger(out, spec, val);
+        }
+    }
+
+    template <typename T> requires std::is_floating_point_v<T>
+    static void writeArg(Output& out, const LogFormatSpec& spec, T val) {
+        // 按参数自身的类型转换（float 的最短表示是 0.1 而不是 0.10000000149011612），
+        // 缓冲区足以容纳最大指数的定点表示加最大精度
+        char tmp[std::numeric_limits<T>::max_exponent10 + 300];
+        std::to_chars_result res;
+        switch (spec.type) {
+            case 'f':
+                res = std::to_chars(tmp, tmp + sizeof(tmp), val, std::chars_format::fixed,
+                                    spec.precision < 0 ? 6 : spec.precision);
+                break;
+            case 'e':
+                res = std::to_chars(tmp, tmp + sizeof(tmp), val, std::chars_format::scientific,
+                                    spec.precision < 0 ? 6 : spec.precision);
+                break;
+            case 'g':
+                res = std::to_chars(tmp, tmp + sizeof(tmp), val, std::chars_format::general,
+                                    spec.precision < 0 ? 6 : spec.precision);
+                break;
+            default:
+                // 未指定类型：无精度时输出该类型可往返的最短表示，与 std::format 一致
+                res = spec.precision < 0
+                    ? std::to_chars(tmp, tmp + sizeof(tmp), val)
+                    : std::to_chars(tmp, tmp + sizeof(tmp), val, std::chars_format::general, spec.precision);
+                break;
+        }
+        if (res.ec != std::errc()) return;
+        writePadded(out, tmp, static_cast<size_t>(res.ptr - tmp), spec, true);
+    }
+
+    template <typename T> requires (std::is_convertible_v<const T&, std::string_view> &&
+                                    !std::is_pointer_v<T> && !std::is_null_pointer_v<T>)
+    static void writeArg(Output& out, const LogFormatSpec& spec, const T& val) {
+        std::string_view text(val);
+        if (spec.precision >= 0 && text.size() > static_cast<size_t>(spec.precision)) {
+            text = text.substr(0, static_cast<size_t>(spec.precision));
+        }
+        writePadded(out, text.data(), text.size(), spec, false);
+    }
+
+    static void writeArg(Output& out, const LogFormatSpec& spec, const char* val) {
+        writeArg(out, spec, std::string_view(val ? val : "(null)"));
+    }
+
+    static void writeArg(Output& out, const LogFormatSpec& spec, char* val) {
+        writeArg(out, spec, static_cast<const char*>(val));
+    }
+
+    template <typename T> requires std::is_pointer_v<T>
+    static void writeArg(Output& out, const LogFormatSpec& spec, T val) {
+        char tmp[2 + 2 * sizeof(uintptr_t)] = {'0', 'x'};
+        auto res = std::to_chars(tmp + 2, tmp + sizeof(tmp),
+                                 reinterpret_cast<uintptr_t>(static_cast<const volatile void*>(val)), 16);
+        writePadded(out, tmp, static_cast<size_t>(res.ptr - tmp), spec, false);
+    }
+
+    static void writeArg(Output& out, const LogFormatSpec& spec, std::nullptr_t) {
+        writePadded(out, "0x0", 3, spec, false);
+    }
+};
+
+/**
+ * @brief 单生产者/单消费者无锁环形缓冲区
+ * @details 每个生产线程独占一个实例，记录以变长条目（头部 + 消息字节）
+ *          连续存放；生产者只做一次 memcpy 和一次 release store，
+ *          消费者（后台线程）直接在缓冲区内读取记录，无需额外拷贝
+ */
+class LogRingBuffer {
+public:
+    /**
+     * @brief 构造函数
+     * @param capacity 缓冲区字节数，向上取整为 2 的幂
+     */
+    explicit LogRingBuffer(size_t capacity)
+        : capacity_(roundUpPow2(capacity)), mask_(capacity_ - 1),
+          buffer_(new char[capacity_]), cachedTail_(0),
+          head_(0), tail_(0), retired_(false) {}
+
+    LogRingBuffer(const LogRingBuffer&) = delete;
+    LogRingBuffer& operator=(const LogRingBuffer&) = delete;
+
+    /**
+     * @brief 单条记录允许的最大消息长度
+     * @details 限制为容量的 1/4，保证回绕填充后仍能放下
+     */
+    size_t maxMessageLength() const {
+        return capacity_ / 4 - sizeof(Entry);
+    }
+
+    /**
+     * @brief 生产者：尝试写入一条记录
+     * @param record 日志记录
+     * @return 空间不足时返回 false
+     */
+    bool tryPush(const LogRecord& record) {
+        const size_t total = entrySize(record.length);
+        const size_t head = head_.load(std::memory_order_relaxed);
+        const size_t index = head & mask_;
+        const size_t contiguous = capacity_ - index;
+        const size_t needed = total <= contiguous ? total : contiguous + total;
+
+        if (capacity_ - (head - cachedTail_) < needed) {
+            cachedTail_ = tail_.load(std::memory_order_acquire);
+            if (capacity_ - (head - cachedTail_) < needed) return false;
+        }
+
+        size_t pos = head;
+        if (total > contiguous) {
+            // 尾部空间不足：写入填充标记后回绕到起点
+            const uint32_t pad[2] = {static_cast<uint32_t>(contiguous), 1};
+            std::memcpy(buffer_.get() + index, pad, sizeof(pad));
+            pos += contiguous;
+        }
+
+        Entry entry{static_cast<uint32_t>(total), 0, record};
+        char* dst = buffer_.get() + (pos & mask_);
+        std::memcpy(dst, &entry, sizeof(entry));
+        std::memcpy(dst + sizeof(entry), record.message, record.length);
+
+        head_.store(pos + total, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief 消费者：依次处理当前可见的全部记录
+     * @param fn 回调，参数为 const LogRecord&
+     * @return 处理的记录条数
+     */
+    template <typename Fn>
+    size_t consume(Fn&& fn) {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        const size_t head = head_.load(std::memory_order_acquire);
+        size_t count = 0;
+
+        while (tail != head) {
+            const char* src = buffer_.get() + (tail & mask_);
+            uint32_t prefix[2];
+            std::memcpy(prefix, src, sizeof(prefix));
+            if (prefix[1] == 0) {
+                Entry entry;
+                std::memcpy(&entry, src, sizeof(entry));
+                entry.record.message = src + sizeof(entry);
+                fn(entry.record);
+                ++count;
+            }
+            tail += prefix[0];
+        }
+
+        tail_.store(tail, std::memory_order_release);
+        return count;
+    }
+
+    /**
+     * @brief 消费者：缓冲区是否为空
+     */
+    bool empty() const {
+        return head_.load(std::memory_order_acquire) ==
+               tail_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief 标记所属线程已退出，消费者排空后即可回收
+     */
+    void retire() { retired_.store(true, std::memory_order_release); }
+
+    /**
+     * @brief 所属线程是否已退出
+     */
+    bool isRetired() const { return retired_.load(std::memory_order_acquire); }
+
+private:
+    /**
+     * @brief 条目头部，紧随其后存放消息字节
+     * @details 前两个字段兼作填充标记（padding != 0 表示回绕填充）
+     */
+    struct Entry {
+        uint32_t size;     ///< 条目总字节数（8 字节对齐）
+        uint32_t padding;  ///< 是否为填充条目
+        LogRecord record;  ///< 记录头（message 指针在读取时重定位）
+    };
+
+    static size_t roundUpPow2(size_t n) {
+        size_t cap = 1024;
+        while (cap < n) cap <<= 1;
+        return cap;
+    }
+
+    static size_t entrySize(size_t length) {
+        return (sizeof(Entry) + length + 7) & ~static_cast<size_t>(7);
+    }
+
+    const size_t capacity_;                  ///< 容量（2 的幂）
+    const size_t mask_;                      ///< 下标掩码
+    std::unique_ptr<char[]> buffer_;         ///< 数据区
+    size_t cachedTail_;                      ///< 生产者缓存的读位置，减少跨核读取
+    alignas(64) std::atomic<size_t> head_;   ///< 写位置（生产者独占写）
+    alignas(64) std::atomic<size_t> tail_;   ///< 读位置（消费者独占写）
+    std::atomic<bool> retired_;              ///< 所属线程是否已退出
+};
+
+/**
+ * @brief 文件提交时的持久化级别
+ */
+enum class FileDurability {
+    None,           ///< 不主动刷新，由 stdio 缓冲区写满或关闭文件时写出
+    FlushToKernel,  ///< 提交时 fflush，数据进入内核页缓存
+    Fdatasync       ///< 提交时 fflush + fdatasync，数据落盘
+};
+
+/**
+ * @brief 文件组提交策略
+ * @details 记录先累积在 stdio 缓冲区中，满足任一条件时一次性提交：
+ *          累积字节数达到 flushBytes、距上次提交超过 flushInterval、
+ *          或写入 ERROR 记录且 flushOnError 为 true。
+ *          默认值与逐条 fflush 的旧行为一致
+ */
+struct FileCommitPolicy {
+    size_t flushBytes = 0;                         ///< 字节阈值，0 表示每条记录都提交
+    std::chrono::milliseconds flushInterval{0};    ///< 时间阈值，0 表示不按时间提交
+    FileDurability durability = FileDurability::FlushToKernel; ///< 提交时的持久化级别
+    bool flushOnError = true;                      ///< ERROR 记录是否立即提交
+};
+
+/**
+ * @brief 文件写出后端
+ */
+enum class FileBackend {
+    Stdio,          ///< stdio FILE*，按组提交策略 fflush（默认）
+    DoubleBuffered, ///< 前后台双缓冲，由专用线程整块 write
+    IoUring,        ///< 双缓冲 + io_uring 异步提交（仅 Linux，不可用时退回 DoubleBuffered）
+    Mmap,           ///< 内存映射分段写入（POSIX，不可用时退回 DoubleBuffered）
+    Direct          ///< 双缓冲 + O_DIRECT 对齐写入，绕过页缓存（POSIX，不可用时退回 DoubleBuffered）
+};
+
+/**
+ * @brief 底层文件描述符操作（屏蔽平台差异）
+ */
+struct LogFileIO {
+    /**
+     * @brief 以追加方式打开（必要时创建）文件
+     * @return 文件描述符，失败返回 -1
+     */
+    static int openAppend(const std::string& path, int extraFlags = 0) {
+        #ifdef _WIN32
+        return _open(path.c_str(), _O_WRONLY | _O_APPEND | _O_CREAT | _O_BINARY | extraFlags,
+                     _S_IREAD | _S_IWRITE);
+        #else
+        return ::open(path.c_str(), O_WRONLY | O_APPEND | O_CREAT | O_CLOEXEC | extraFlags, 0644);
+        #endif
+    }
+
+    /**
+     * @brief 写出全部数据（处理短写和 EINTR）
+     * @return 成功写出全部数据时返回 true
+     */
+    static bool writeAll(int fd, const char* data, size_t length) {
+        while (length > 0) {
+            #ifdef _WIN32
+            int n = _write(fd, data, static_cast<unsigned>(length));
+            #else
+            ssize_t n = ::write(fd, data, length);
+            if (n < 0 && errno == EINTR) continue;
+            #endif
+            if (n <= 0) return false;
+            data += n;
+            length -= static_cast<size_t>(n);
+        }
+        return true;
+    }
+
+    /**
+     * @brief 将文件数据同步到磁盘（仅数据，不含元数据）
+     */
+    static void syncData(int fd) {
+        #ifdef _WIN32
+        _commit(fd);
+        #elif defined(__APPLE__)
+        fsync(fd);
+        #else
+        fdatasync(fd);
+        #endif
+    }
+
+    /**
+     * @brief 关闭文件描述符
+     */
+    static void close(int fd) {
+        #ifdef _WIN32
+        _close(fd);
+        #else
+        ::close(fd);
+        #endif
+    }
+
+    /**
+     * @brief 文件大小（不存在时为 0）
+     */
+    static uint64_t fileSize(const std::string& path) {
+        #ifdef _WIN32
+        struct _stat64 st;
+        return _stat64(path.c_str(), &st) == 0 ? static_cast<uint64_t>(st.st_size) : 0;
+        #else
+        struct stat st;
+        return ::stat(path.c_str(), &st) == 0 ? static_cast<uint64_t>(st.st_size) : 0;
+        #endif
+    }
+
+    /**
+     * @brief 文件存在且为空时删除
+     */
+    static void removeIfEmpty(const std::string& path) {
+        #ifdef _WIN32
+        struct _stat64 st;
+        if (_stat64(path.c_str(), &st) == 0 && st.st_size == 0) {
+            _unlink(path.c_str());
+        }
+        #else
+        struct stat st;
+        if (::stat(path.c_str(), &st) == 0 && st.st_size == 0) {
+            ::unlink(path.c_str());
+        }
+        #endif
+    }
+};
+
+/**
+ * @brief 日志文件空间预分配
+ * @details Linux 上以 FALLOC_FL_KEEP_SIZE 在文件末尾之后按 chunk 预留连续的块：文件大小不变，
+ *          读者看不到零填充，追加写入直接落在已分配的区段上，不必每次写入都更新块分配元数据，
+ *          文件也不会随零散追加而碎片化。关闭时按当前文件大小 ftruncate，释放未用完的预留尾部。
+ *          文件系统不支持时自动停用；其他平台为空操作
+ */
+class LogFilePreallocator {
+public:
+    LogFilePreallocator() : fd_(-1), chunk_(0), size_(0), reserved_(0) {}
+
+    /**
+     * @brief 关联已打开的文件并预留第一段
+     * @param chunk 每次预留的字节数，0 表示不预分配
+     */
+    void attach(int fd, size_t chunk) {
+        fd_ = fd;
+        chunk_ = chunk;
+        #ifdef __linux__
+        struct stat st;
+        size_ = fstat(fd, &st) == 0 ? static_cast<uint64_t>(st.st_size) : 0;
+        reserved_ = size_;
+        if (chunk_ != 0) {
+            extend();
+        }
+        #else
+        chunk_ = 0;
+        #endif
+    }
+
+    /**
+     * @brief 记录即将追加的字节数，超出已预留范围时再预留一段
+     */
+    void advance(size_t length) {
+        size_ += length;
+        if (size_ > reserved_ && chunk_ != 0) {
+            extend();
+        }
+    }
+
+    /**
+     * @brief 释放未用完的预留空间（须在所有写入完成后、关闭文件前调用）
+     */
+    void trim() {
+        #ifdef __linux__
+        if (fd_ >= 0 && reserved_ > 0) {
+            // 截断到当前大小：文件内容不变，末尾之后的预留块被释放
+            struct stat st;
+            if (fstat(fd_, &st) == 0 && ftruncate(fd_, st.st_size) != 0) {
+                // 截断失败只会多占用预留的空间
+            }
+        }
+        #endif
+        fd_ = -1;
+        chunk_ = 0;
+        size_ = 0;
+        reserved_ = 0;
+    }
+
+private:
+    /**
+     * @brief 把预留范围扩展到 size_ 之后的下一个 chunk 边界
+     */
+    void extend() {
+        #ifdef __linux__
+        const uint64_t end = (size_ / chunk_ + 1) * chunk_;
+        if (fallocate(fd_, FALLOC_FL_KEEP_SIZE, static_cast<off_t>(reserved_),
+                      static_cast<off_t>(end - reserved_)) == 0) {
+            reserved_ = end;
+            return;
+        }
+        #endif
+        chunk_ = 0; // 不支持预分配：不再尝试
+    }
+
+    int fd_;            ///< 文件描述符
+    size_t chunk_;      ///< 每次预留的字节数（0 表示停用）
+    uint64_t size_;     ///< 已写入（含即将写入）的文件大小
+    uint64_t reserved_; ///< 已预留到的文件偏移
+};
+
+/**
+ * @brief 日志文件写入器接口
+ * @details Logger 负责格式化、轮转和组提交策略，写入器只负责把字节送到文件。
+ *          所有方法均在持有 Logger 互斥锁时调用
+ */
+class LogFileWriter {
+public:
+    virtual ~LogFileWriter() = default;
+
+    /**
+     * @brief 打开文件（追加写）
+     * @param path 文件路径
+     * @param policy 组提交策略
+     * @return 打开成功返回 true
+     */
+    virtual bool open(const std::string& path, const FileCommitPolicy& policy) = 0;
+
+    /**
+     * @brief 写出残留数据并关闭文件
+     */
+    virtual void close() = 0;
+
+    /**
+     * @brief 追加一段已格式化的日志数据
+     */
+    virtual void write(const char* data, size_t length) = 0;
+
+    /**
+     * @brief 同步提交已追加的数据，返回时数据已交给内核（或按 durability 落盘）
+     */
+    virtual void commit(FileDurability durability) = 0;
+
+    /**
+     * @brief 是否由写入器自行批量提交
+     * @details 返回 true 时 Logger 不再按 flushBytes/flushInterval 调用 commit，
+     *          ERROR 记录只调用非阻塞的 requestCommit
+     */
+    virtual bool selfCommitting() const { return false; }
+
+    /**
+     * @brief 请求尽快提交（非阻塞）
+     */
+    virtual void requestCommit() {}
+
+    /**
+     * @brief 因写入或映射失败而丢弃的字节数
+     */
+    virtual uint64_t droppedBytes() const { return 0; }
+
+    /**
+     * @brief 设置空间预分配的步长（open 之前调用，0 表示不预分配）
+     */
+    void setPreallocation(size_t chunk) { preallocate_ = chunk; }
+
+protected:
+    size_t preallocate_ = 0; ///< 空间预分配步长
+};
+
+/**
+ * @brief 基于 stdio 的文件写入器
+ * @details 缓冲区按 flushBytes 设置，使一个提交批次只产生一次 write
+ */
+class StdioFileWriter : public LogFileWriter {
+public:
+    StdioFileWriter() : handle_(nullptr) {}
+    ~StdioFileWriter() override { close(); }
+
+    bool open(const std::string& path, const FileCommitPolicy& policy) override {
+        #ifdef _WIN32
+        fopen_s(&handle_, path.c_str(), "a");
+        #else
+        handle_ = fopen(path.c_str(), "a");
+        #endif
+        if (!handle_) return false;
+
+        // 组提交：让 stdio 缓冲区至少容纳一个提交批次，避免批次内部的零散 write
+        if (policy.flushBytes > BUFSIZ) {
+            setvbuf(handle_, nullptr, _IOFBF, policy.flushBytes);
+        }
+        #ifndef _WIN32
+        preallocator_.attach(fileno(handle_), preallocate_);
+        #endif
+        return true;
+    }
+
+    void close() override {
+        if (handle_) {
+            fflush(handle_);
+            preallocator_.trim();
+            fclose(handle_);
+            handle_ = nullptr;
+        }
+    }
+
+    void write(const char* data, size_t length) override {
+        preallocator_.advance(length);
+        fwrite(data, 1, length, handle_);
+    }
+
+    void commit(FileDurability durability) override {
+        fflush(handle_);
+        if (durability == FileDurability::Fdatasync) {
+            #ifdef _WIN32
+            LogFileIO::syncData(_fileno(handle_));
+            #else
+            LogFileIO::syncData(fileno(handle_));
+            #endif
+        }
+    }
+
+private:
+    FILE* handle_;                     ///< 文件句柄
+    LogFilePreallocator preallocator_; ///< 空间预分配
+};
+
+/**
+ * @brief 前后台双缓冲文件写入器
+ * @details 调用方只在极短的临界区内把日志追加到前台缓冲区；
+ *          专用线程在缓冲区达到阈值、超过提交间隔或收到提交请求时
+ *          交换前后台缓冲区，并用一次 write 写出整块后台缓冲区。
+ *          前台缓冲区超过容量 4 倍时调用方阻塞等待，内存占用有上限
+ */
+class DoubleBufferFileWriter : public LogFileWriter {
+public:
+    static constexpr auto DEFAULT_SWAP_INTERVAL = std::chrono::milliseconds(100); ///< 默认交换间隔
+
+    /**
+     * @brief 构造函数
+     * @param bufferSize 单个缓冲区的目标大小
+     */
+    explicit DoubleBufferFileWriter(size_t bufferSize)
+        : fd_(-1), capacity_(bufferSize), threshold_(bufferSize / 2),
+          durability_(FileDurability::FlushToKernel), interval_(DEFAULT_SWAP_INTERVAL),
+          stop_(false), requested_(0), completed_(0) {}
+
+    ~DoubleBufferFileWriter() override { close(); }
+
+    bool open(const std::string& path, const FileCommitPolicy& policy) override {
+        if (!openFile(path)) return false;
+
+        preallocator_.attach(fd_, preallocationChunk());
+        durability_ = policy.durability;
+        interval_ = policy.flushInterval.count() > 0 ? policy.flushInterval : DEFAULT_SWAP_INTERVAL;
+        threshold_ = policy.flushBytes > 0 ? std::min(policy.flushBytes, capacity_) : capacity_ / 2;
+        front_.reserve(capacity_);
+        back_.reserve(capacity_);
+        stop_ = false;
+        thread_ = std::thread(&DoubleBufferFileWriter::run, this);
+        return true;
+    }
+
+    void close() override {
+        if (fd_ < 0) return;
+        stopThread();
+        closeFile();
+    }
+
+    void write(const char* data, size_t length) override {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (front_.size() + length > capacity_ * 4) {
+            // 写盘跟不上：等待后台线程交换出空缓冲区
+            wakeCv_.notify_one();
+            doneCv_.wait(lock, [&] { return front_.size() + length <= capacity_ * 4 || front_.empty(); });
+        }
+        const bool wasBelow = front_.size() < threshold_;
+        front_.insert(front_.end(), data, data + length);
+        if (wasBelow && front_.size() >= threshold_) {
+            lock.unlock();
+            wakeCv_.notify_one();
+        }
+    }
+
+    void commit(FileDurability durability) override {
+        std::unique_lock<std::mutex> lock(mutex_);
+        const uint64_t ticket = ++requested_;
+        commitDurability_ = durability;
+        wakeCv_.notify_one();
+        doneCv_.wait(lock, [&] { return completed_ >= ticket; });
+    }
+
+    bool selfCommitting() const override { return true; }
+
+    void requestCommit() override {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            ++requested_;
+        }
+        wakeCv_.notify_one();
+    }
+
+protected:
+    /**
+     * @brief 打开文件（写线程启动前调用）
+     */
+    virtual bool openFile(const std::string& path) {
+        fd_ = LogFileIO::openAppend(path);
+        return fd_ >= 0;
+    }
+
+    /**
+     * @brief 关闭文件（写线程退出后调用）
+     */
+    virtual void closeFile() {
+        preallocator_.trim();
+        LogFileIO::close(fd_);
+        fd_ = -1;
+    }
+
+    /**
+     * @brief 空间预分配步长，不适合预分配的子类返回 0
+     */
+    virtual size_t preallocationChunk() const { return preallocate_; }
+
+    /**
+     * @brief 写出一整块数据（在写线程中调用）
+     * @param block 待写数据，返回时必须为空（可以交换出去）
+     * @param sync 写出后是否同步到磁盘
+     */
+    virtual void writeBlock(std::vector<char>& block, bool sync) {
+        if (!block.empty()) {
+            LogFileIO::writeAll(fd_, block.data(), block.size());
+            block.clear();
+        }
+        if (sync) {
+            LogFileIO::syncData(fd_);
+        }
+    }
+
+    /**
+     * @brief 等待此前发出的写操作全部完成（在写线程中调用）
+     */
+    virtual void waitWrites() {}
+
+    /**
+     * @brief 写线程退出前调用，子类须在析构前停止写线程
+     */
+    void stopThread() {
+        if (fd_ < 0) return;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        wakeCv_.notify_one();
+        thread_.join();
+    }
+
+    int fd_;                           ///< 文件描述符
+    LogFilePreallocator preallocator_; ///< 空间预分配（写线程中推进，关闭前释放尾部）
+
+private:
+    /**
+     * @brief 后台写线程
+     */
+    void run() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        for (;;) {
+            wakeCv_.wait_for(lock, interval_, [&] {
+                return stop_ || requested_ > completed_ || front_.size() >= threshold_;
+            });
+
+            const uint64_t ticket = requested_;
+            const bool stopping = stop_;
+            const FileDurability durability =
+                ticket > completed_ ? commitDurability_ : durability_;
+
+            front_.swap(back_);
+            lock.unlock();
+            doneCv_.notify_all(); // 唤醒等待空间的调用方
+
+            const bool commitRequested = ticket > completed_;
+            const bool wrote = !back_.empty();
+            const bool sync = durability == FileDurability::Fdatasync && (wrote || commitRequested);
+            if (wrote || sync) {
+                preallocator_.advance(back_.size());
+                writeBlock(back_, sync);
+            }
+            if (commitRequested) {
+                waitWrites();
+            }
+
+            lock.lock();
+            completed_ = ticket;
+            doneCv_.notify_all();
+            if (stopping && front_.empty()) break;
+        }
+    }
+
+    const size_t capacity_;              ///< 单个缓冲区的目标大小
+    size_t threshold_;                   ///< 触发交换的字节阈值
+    FileDurability durability_;          ///< 周期写出后的持久化级别
+    FileDurability commitDurability_ = FileDurability::FlushToKernel; ///< 显式提交的持久化级别
+    std::chrono::milliseconds interval_; ///< 交换间隔
+    std::vector<char> front_;            ///< 前台缓冲区（调用方追加）
+    std::vector<char> back_;             ///< 后台缓冲区（写线程写出）
+    std::mutex mutex_;                   ///< 保护 front_ 和状态字段
+    std::condition_variable wakeCv_;     ///< 唤醒写线程
+    std::condition_variable doneCv_;     ///< 通知写出完成
+    std::thread thread_;                 ///< 写线程
+    bool stop_;                          ///< 通知写线程退出
+    uint64_t requested_;                 ///< 已请求的提交序号
+    uint64_t completed_;                 ///< 已完成的提交序号
+};
+
+#ifdef LOGGER_HAS_IO_URING
+/**
+ * @brief 基于 io_uring 的文件写入器（Linux）
+ * @details 在双缓冲的基础上，写线程把交换出的整块数据作为带显式偏移的写请求
+ *          提交给 io_uring 后立即返回，最多 QUEUE_DEPTH 块同时在途；
+ *          Fdatasync 级别下追加一个 IOSQE_IO_DRAIN 的 fdatasync 请求。
+ *          慢盘只会让在途请求变多，不会阻塞写线程接收新的数据，
+ *          只有在途缓冲区全部用完或显式提交时才等待完成
+ */
+class IoUringFileWriter : public DoubleBufferFileWriter {
+public:
+    static constexpr unsigned QUEUE_DEPTH = 4; ///< 同时在途的写缓冲区数
+
+    explicit IoUringFileWriter(size_t bufferSize)
+        : DoubleBufferFileWriter(bufferSize), ringFd_(-1), offset_(0), inFlight_(0), degraded_(false) {}
+
+    ~IoUringFileWriter() override {
+        // 写线程会调用虚函数，必须在本类析构前停止
+        close();
+    }
+
+    /**
+     * @brief 当前内核是否支持 io_uring 及所需的 IORING_OP_WRITE / IORING_OP_FSYNC
+     * @details IORING_OP_WRITE 自 5.6 起提供，与 IORING_REGISTER_PROBE 同时引入；
+     *          探测失败（5.1–5.5 内核）视为不支持，由调用方选择普通写出后端
+     */
+    static bool available() {
+        static const bool supported = [] {
+            io_uring_params params{};
+            int fd = static_cast<int>(syscall(__NR_io_uring_setup, 1, &params));
+            if (fd < 0) return false;
+
+            constexpr unsigned OPS = 256;
+            std::vector<char> storage(sizeof(io_uring_probe) + OPS * sizeof(io_uring_probe_op), 0);
+            auto* probe = reinterpret_cast<io_uring_probe*>(storage.data());
+            const bool probed = syscall(__NR_io_uring_register, fd, IORING_REGISTER_PROBE, probe, OPS) >= 0;
+            ::close(fd);
+            if (!probed) return false;
+
+            auto has = [probe](unsigned op) {
+                return op <= probe->last_op && (probe->ops[op].flags & IO_URING_OP_SUPPORTED) != 0;
+            };
+            return has(IORING_OP_WRITE) && has(IORING_OP_FSYNC);
+        }();
+        return supported;
+    }
+
+    /**
+     * @brief io_uring_enter 失败后是否已退回同步 pwrite 写出
+     */
+    bool degraded() const { return degraded_.load(std::memory_order_relaxed); }
+
+protected:
+    bool openFile(const std::string& path) override {
+        // 不使用 O_APPEND：每个写请求携带显式偏移，多个请求可以并行完成
+        fd_ = ::open(path.c_str(), O_WRONLY | O_CREAT | O_CLOEXEC, 0644);
+        if (fd_ < 0) return false;
+        const off_t end = ::lseek(fd_, 0, SEEK_END);
+        offset_ = end > 0 ? static_cast<uint64_t>(end) : 0;
+
+        if (!setupRing()) {
+            ::close(fd_);
+            fd_ = -1;
+            return false;
+        }
+        for (auto& buffer : buffers_) buffer.clear();
+        for (unsigned i = 0; i < QUEUE_DEPTH; ++i) busy_[i] = false;
+        degraded_.store(false, std::memory_order_relaxed);
+        return true;
+    }
+
+    void closeFile() override {
+        // 截断预留尾部前必须等在途写请求完成
+        waitWrites();
+        teardownRing();
+        preallocator_.trim();
+        ::close(fd_);
+        fd_ = -1;
+    }
+
+    void writeBlock(std::vector<char>& block, bool sync) override {
+        if (degraded()) {
+            writeAt(block.data(), block.size(), offset_);
+            offset_ += block.size();
+            block.clear();
+            if (sync) LogFileIO::syncData(fd_);
+            return;
+        }
+
+        // 限制在途请求数，保证完成队列不会溢出
+        while (inFlight_ + 2 > QUEUE_DEPTH * 2 && !degraded()) {
+            reap(true);
+        }
+        if (degraded()) {
+            writeBlock(block, sync);
+            return;
+        }
+
+        unsigned toSubmit = 0;
+        if (!block.empty()) {
+            unsigned index = acquireBuffer();
+            if (degraded()) {
+                writeBlock(block, sync);
+                return;
+            }
+            buffers_[index].swap(block);
+            block.clear();
+
+            io_uring_sqe* sqe = nextSqe();
+            sqe->opcode = IORING_OP_WRITE;
+            sqe->fd = fd_;
+            sqe->addr = reinterpret_cast<uint64_t>(buffers_[index].data());
+            sqe->len = static_cast<uint32_t>(buffers_[index].size());
+            sqe->off = offset_;
+            sqe->user_data = index;
+            starts_[index] = offset_;
+            offset_ += buffers_[index].size();
+            busy_[index] = true;
+            ++inFlight_;
+            ++toSubmit;
+        }
+        if (sync) {
+            io_uring_sqe* sqe = nextSqe();
+            sqe->opcode = IORING_OP_FSYNC;
+            sqe->fd = fd_;
+            sqe->fsync_flags = IORING_FSYNC_DATASYNC;
+            sqe->flags = IOSQE_IO_DRAIN; // 在此前的写请求完成后执行
+            sqe->user_data = SYNC_TAG;
+            ++inFlight_;
+            ++toSubmit;
+        }
+        if (!enter(toSubmit, 0)) {
+            degrade();
+            if (sync) LogFileIO::syncData(fd_);
+            return;
+        }
+        reap(false);
+    }
+
+    void waitWrites() override {
+        while (inFlight_ > 0) {
+            reap(true);
+        }
+    }
+
+private:
+    static constexpr uint64_t SYNC_TAG = ~uint64_t(0); ///< fdatasync 请求的 user_data
+
+    bool setupRing() {
+        io_uring_params params{};
+        ringFd_ = static_cast<int>(syscall(__NR_io_uring_setup, QUEUE_DEPTH * 2, &params));
+        if (ringFd_ < 0) return false;
+
+        sqRingSize_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cqRingSize_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        sqesSize_ = params.sq_entries * sizeof(io_uring_sqe);
+
+        sqRing_ = mmap(nullptr, sqRingSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                       ringFd_, IORING_OFF_SQ_RING);
+        cqRing_ = mmap(nullptr, cqRingSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                       ringFd_, IORING_OFF_CQ_RING);
+        sqes_ = static_cast<io_uring_sqe*>(mmap(nullptr, sqesSize_, PROT_READ | PROT_WRITE,
+                                                MAP_SHARED | MAP_POPULATE, ringFd_, IORING_OFF_SQES));
+        if (sqRing_ == MAP_FAILED || cqRing_ == MAP_FAILED || sqes_ == MAP_FAILED) {
+            teardownRing();
+            return false;
+        }
+
+        char* sq = static_cast<char*>(sqRing_);
+        sqTail_ = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        sqMask_ = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        sqArray_ = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+
+        char* cq = static_cast<char*>(cqRing_);
+        cqHead_ = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        cqTail_ = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        cqMask_ = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        cqes_ = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+        inFlight_ = 0;
+        return true;
+    }
+
+    void teardownRing() {
+        if (sqRing_ && sqRing_ != MAP_FAILED) munmap(sqRing_, sqRingSize_);
+        if (cqRing_ && cqRing_ != MAP_FAILED) munmap(cqRing_, cqRingSize_);
+        if (sqes_ && sqes_ != MAP_FAILED) munmap(sqes_, sqesSize_);
+        sqRing_ = cqRing_ = nullptr;
+        sqes_ = nullptr;
+        if (ringFd_ >= 0) ::close(ringFd_);
+        ringFd_ = -1;
+    }
+
+    /**
+     * @brief 取下一个提交槽并清零（调用方随后 enter 提交）
+     */
+    io_uring_sqe* nextSqe() {
+        const unsigned tail = *sqTail_;
+        const unsigned index = tail & sqMask_;
+        io_uring_sqe* sqe = &sqes_[index];
+        std::memset(sqe, 0, sizeof(*sqe));
+        sqArray_[index] = index;
+        __atomic_store_n(sqTail_, tail + 1, __ATOMIC_RELEASE);
+        return sqe;
+    }
+
+    /**
+     * @brief 提交请求并（可选）等待完成
+     * @return EINTR 之外的错误返回 false
+     */
+    bool enter(unsigned toSubmit, unsigned minComplete) {
+        const unsigned flags = minComplete > 0 ? IORING_ENTER_GETEVENTS : 0;
+        for (;;) {
+            if (syscall(__NR_io_uring_enter, ringFd_, toSubmit, minComplete, flags, nullptr, 0) >= 0) {
+                return true;
+            }
+            if (errno != EINTR) return false;
+        }
+    }
+
+    /**
+     * @brief io_uring_enter 持续失败：同步补写所有在途缓冲区，此后改用 pwrite
+     * @details 在途请求可能已部分或全部完成，按原偏移重写同样的数据不会改变文件内容；
+     *          缓冲区此后不再复用，内核即使仍在读取也不受影响
+     */
+    void degrade() {
+        degraded_.store(true, std::memory_order_relaxed);
+        for (unsigned i = 0; i < QUEUE_DEPTH; ++i) {
+            if (busy_[i]) finishWrite(i, 0);
+        }
+        inFlight_ = 0;
+        teardownRing();
+    }
+
+    /**
+     * @brief 回收已完成的请求
+     * @param wait true 时至少等待一个请求完成
+     */
+    void reap(bool wait) {
+        if (degraded()) return;
+        if (wait && !enter(0, 1)) {
+            degrade();
+            return;
+        }
+
+        unsigned head = *cqHead_;
+        const unsigned tail = __atomic_load_n(cqTail_, __ATOMIC_ACQUIRE);
+        while (head != tail) {
+            const io_uring_cqe& cqe = cqes_[head & cqMask_];
+            if (cqe.user_data != SYNC_TAG) {
+                finishWrite(static_cast<unsigned>(cqe.user_data), cqe.res);
+            }
+            --inFlight_;
+            ++head;
+        }
+        __atomic_store_n(cqHead_, head, __ATOMIC_RELEASE);
+    }
+
+    /**
+     * @brief 处理一个写请求的完成事件
+     * @details 短写或出错时用同步 pwrite 补写剩余部分，保证数据不丢失
+     */
+    void finishWrite(unsigned index, int res) {
+        std::vector<char>& buffer = buffers_[index];
+        const size_t done = res > 0 ? static_cast<size_t>(res) : 0;
+        if (done < buffer.size()) {
+            writeAt(buffer.data() + done, buffer.size() - done, starts_[index] + done);
+        }
+        buffer.clear();
+        busy_[index] = false;
+    }
+
+    /**
+     * @brief 同步 pwrite 写出 [data, data + length) 到文件偏移 start
+     */
+    void writeAt(const char* data, size_t length, uint64_t start) {
+        size_t pos = 0;
+        while (pos < length) {
+            ssize_t n = ::pwrite(fd_, data + pos, length - pos, static_cast<off_t>(start + pos));
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) break;
+            pos += static_cast<size_t>(n);
+        }
+    }
+
+    /**
+     * @brief 获取一个空闲缓冲区，全部在途时等待完成
+     */
+    unsigned acquireBuffer() {
+        for (;;) {
+            for (unsigned i = 0; i < QUEUE_DEPTH; ++i) {
+                if (!busy_[i]) return i;
+            }
+            reap(true);
+        }
+    }
+
+    int ringFd_;                         ///< io_uring 实例
+    void* sqRing_ = nullptr;             ///< 提交队列映射
+    void* cqRing_ = nullptr;             ///< 完成队列映射
+    io_uring_sqe* sqes_ = nullptr;       ///< 提交项数组映射
+    size_t sqRingSize_ = 0;
+    size_t cqRingSize_ = 0;
+    size_t sqesSize_ = 0;
+    unsigned* sqTail_ = nullptr;
+    unsigned sqMask_ = 0;
+    unsigned* sqArray_ = nullptr;
+    unsigned* cqHead_ = nullptr;
+    unsigned* cqTail_ = nullptr;
+    unsigned cqMask_ = 0;
+    io_uring_cqe* cqes_ = nullptr;
+    uint64_t offset_;                    ///< 下一个写请求的文件偏移
+    unsigned inFlight_;                  ///< 在途请求数（含 fdatasync）
+    std::atomic<bool> degraded_;         ///< 是否已退回同步 pwrite
+    std::vector<char> buffers_[QUEUE_DEPTH]; ///< 在途写缓冲区
+    bool busy_[QUEUE_DEPTH] = {};        ///< 缓冲区是否在途
+    uint64_t starts_[QUEUE_DEPTH] = {};  ///< 缓冲区对应的文件起始偏移
+};
+#endif
+
+#ifndef _WIN32
+/**
+ * @brief 绕过页缓存的文件写入器（O_DIRECT，POSIX）
+ * @details 在双缓冲的基础上，写线程把交换出的数据拷贝进页对齐的暂存缓冲区，
+ *          以块对齐的偏移和长度一次写出，日志数据不进入页缓存，不会挤占应用的热数据。
+ *          末尾不满一块的数据补零写出后立即把文件截断回真实长度，
+ *          并保留在暂存缓冲区开头，下一批数据到来时连同该块一起重写。
+ *          文件系统不支持 O_DIRECT 时以普通方式打开，写出逻辑不变
+ */
+class DirectFileWriter : public DoubleBufferFileWriter {
+public:
+    static constexpr size_t IO_ALIGNMENT = 4096; ///< 对齐粒度（覆盖常见的逻辑块大小）
+
+    explicit DirectFileWriter(size_t bufferSize)
+        : DoubleBufferFileWriter(bufferSize), staging_(nullptr, &std::free),
+          stagingCapacity_(0), blockStart_(0), carry_(0), direct_(false), retry_(false),
+          droppedBytes_(0) {}
+
+    ~DirectFileWriter() override {
+        // 写线程会调用虚函数，必须在本类析构前停止
+        close();
+    }
+
+    /**
+     * @brief 文件是否以 O_DIRECT（或 F_NOCACHE）方式打开
+     */
+    bool isDirect() const { return direct_; }
+
+    /**
+     * @brief 因写入持续失败而丢弃的字节数
+     */
+    uint64_t droppedBytes() const override { return droppedBytes_.load(std::memory_order_relaxed); }
+
+    static constexpr size_t RETRY_LIMIT = 16 * 1024 * 1024; ///< 写入失败时暂存待重试数据的上限
+
+protected:
+    /**
+     * @brief 每批写出后都会截掉补零的尾块，同时释放末尾之后的预留块，因此不预分配
+     */
+    size_t preallocationChunk() const override { return 0; }
+
+    bool openFile(const std::string& path) override {
+        #ifdef O_DIRECT
+        fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC | O_DIRECT, 0644);
+        direct_ = fd_ >= 0;
+        #endif
+        if (fd_ < 0) {
+            fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+            if (fd_ < 0) return false;
+            #ifdef F_NOCACHE
+            direct_ = fcntl(fd_, F_NOCACHE, 1) == 0;
+            #endif
+        }
+
+        // 已有文件末尾不满一块的部分读入暂存区，之后与新数据一起重写
+        struct stat st;
+        const uint64_t size = fstat(fd_, &st) == 0 ? static_cast<uint64_t>(st.st_size) : 0;
+        blockStart_ = size - size % IO_ALIGNMENT;
+        carry_ = static_cast<size_t>(size - blockStart_);
+        retry_ = false;
+        reserveStaging(IO_ALIGNMENT);
+        if (carry_ > 0 &&
+            ::pread(fd_, staging_.get(), IO_ALIGNMENT, static_cast<off_t>(blockStart_)) <
+                static_cast<ssize_t>(carry_)) {
+            ::close(fd_);
+            fd_ = -1;
+            return false;
+        }
+        return true;
+    }
+
+    void writeBlock(std::vector<char>& block, bool sync) override {
+        if (!block.empty() || retry_) {
+            const size_t total = carry_ + block.size();
+            const size_t padded = (total + IO_ALIGNMENT - 1) / IO_ALIGNMENT * IO_ALIGNMENT;
+            reserveStaging(padded);
+            std::memcpy(staging_.get() + carry_, block.data(), block.size());
+            std::memset(staging_.get() + total, 0, padded - total);
+            block.clear();
+
+            size_t written = 0;
+            while (written < padded) {
+                ssize_t n = ::pwrite(fd_, staging_.get() + written, padded - written,
+                                     static_cast<off_t>(blockStart_ + written));
+                if (n < 0 && errno == EINTR) continue;
+                if (n <= 0) break;
+                written += static_cast<size_t>(n);
+            }
+
+            if (written < padded) {
+                // 写入失败或不完整：blockStart_ 不前移，数据留在暂存区，下一批从同一偏移整体重写，
+                // 文件中不会出现空洞；暂存数据超过 RETRY_LIMIT 时丢弃本批并计数
+                if (total <= RETRY_LIMIT) {
+                    carry_ = total;
+                } else {
+                    droppedBytes_.fetch_add(total - carry_, std::memory_order_relaxed);
+                }
+                retry_ = true;
+                if (sync) LogFileIO::syncData(fd_);
+                return;
+            }
+            retry_ = false;
+
+            // 保留最后不满一块的数据，截掉补零部分
+            const size_t full = total / IO_ALIGNMENT * IO_ALIGNMENT;
+            carry_ = total - full;
+            if (full > 0 && carry_ > 0) {
+                std::memmove(staging_.get(), staging_.get() + full, carry_);
+            }
+            blockStart_ += full;
+            if (carry_ > 0 && ftruncate(fd_, static_cast<off_t>(blockStart_ + carry_)) != 0) {
+                // 截断失败只会留下尾部的空字节，下一批写入会覆盖
+            }
+        }
+        if (sync) {
+            // O_DIRECT 不保证设备缓存和元数据落盘
+            LogFileIO::syncData(fd_);
+        }
+    }
+
+private:
+    /**
+     * @brief 确保暂存缓冲区至少有 size 字节（保留已有的尾块数据）
+     */
+    void reserveStaging(size_t size) {
+        if (size <= stagingCapacity_) return;
+        size_t capacity = std::max(size, stagingCapacity_ * 2);
+        void* mem = nullptr;
+        if (posix_memalign(&mem, IO_ALIGNMENT, capacity) != 0) throw std::bad_alloc();
+        if (carry_ > 0 && staging_) std::memcpy(mem, staging_.get(), carry_);
+        staging_.reset(static_cast<char*>(mem));
+        stagingCapacity_ = capacity;
+    }
+
+    std::unique_ptr<char, void (*)(void*)> staging_; ///< 页对齐的暂存缓冲区
+    size_t stagingCapacity_;             ///< 暂存缓冲区容量
+    uint64_t blockStart_;                ///< 暂存区开头对应的文件偏移（块对齐）
+    size_t carry_;                       ///< 暂存区开头保留的尾块字节数（含待重试的数据）
+    bool direct_;                        ///< 是否绕过页缓存
+    bool retry_;                         ///< 上一批写入失败，暂存区中有待重写的数据
+    std::atomic<uint64_t> droppedBytes_; ///< 写入失败后丢弃的字节数
+};
+#endif
+
+#ifdef LOGGER_HAS_MMAP
+/**
+ * @brief 内存映射分段文件写入器（POSIX）
+ * @details 文件按固定大小的段映射到内存，写入方通过原子 fetch_add 预留文件偏移，
+ *          再把数据 memcpy 到对应段中，不经过 stdio 锁也没有逐条系统调用；
+ *          并发写入方预留的区间互不重叠，因此 write() 本身不需要互斥锁。
+ *          后台线程提前映射后续的段，并回收已写满的段；
+ *          关闭时把文件截断到实际写入的长度
+ */
+class MmapFileWriter : public LogFileWriter {
+public:
+    static constexpr unsigned SLOTS = 4; ///< 同时映射的段数（含预映射）
+
+    /**
+     * @brief 构造函数
+     * @param segmentSize 段大小，向上取整到页大小的整数倍
+     */
+    explicit MmapFileWriter(size_t segmentSize)
+        : segmentSize_(roundToPage(segmentSize)), fd_(-1), base_(0), offset_(0),
+          nextToMap_(0), stop_(false), droppedBytes_(0) {}
+
+    ~MmapFileWriter() override { close(); }
+
+    bool open(const std::string& path, const FileCommitPolicy&) override {
+        fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+        if (fd_ < 0) return false;
+
+        struct stat st;
+        if (fstat(fd_, &st) != 0) {
+            ::close(fd_);
+            fd_ = -1;
+            return false;
+        }
+        // 段起点按页对齐，已有内容落在第 0 段内，从文件末尾继续追加
+        const uint64_t size = static_cast<uint64_t>(st.st_size);
+        base_ = size - size % pageSize();
+        offset_.store(size, std::memory_order_relaxed);
+        for (auto& slot : slots_) {
+            slot.index.store(NONE, std::memory_order_relaxed);
+            slot.failed.store(NONE, std::memory_order_relaxed);
+            slot.base = nullptr;
+            slot.committed.store(0, std::memory_order_relaxed);
+        }
+        nextToMap_ = 0;
+        stop_ = false;
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            mapAhead();
+        }
+        if (slots_[0].index.load() != 0) {
+            closeMappings(size);
+            return false;
+        }
+        thread_ = std::thread(&MmapFileWriter::run, this);
+        return true;
+    }
+
+    void close() override {
+        if (fd_ < 0) return;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        cv_.notify_one();
+        thread_.join();
+        closeMappings(offset_.load());
+    }
+
+    /**
+     * @brief 追加数据（可被多个线程并发调用）
+     */
+    void write(const char* data, size_t length) override {
+        uint64_t pos = offset_.fetch_add(length, std::memory_order_relaxed) - base_;
+        while (length > 0) {
+            const uint64_t index = pos / segmentSize_;
+            const size_t inSegment = static_cast<size_t>(pos % segmentSize_);
+            const size_t n = std::min(length, segmentSize_ - inSegment);
+
+            Slot* slot = waitSlot(index);
+            if (slot->index.load(std::memory_order_acquire) == index) {
+                std::memcpy(slot->base + inSegment, data, n);
+            } else {
+                // 该段映射失败：丢弃这部分数据并计数，仍计入 committed 以便该段回收
+                droppedBytes_.fetch_add(n, std::memory_order_relaxed);
+            }
+            if (slot->committed.fetch_add(n, std::memory_order_acq_rel) + n == segmentSize_) {
+                cv_.notify_one(); // 段已写满，通知后台线程回收并映射下一段
+            }
+
+            data += n;
+            length -= n;
+            pos += n;
+        }
+    }
+
+    /**
+     * @brief 因映射失败（如磁盘已满）而丢弃的字节数
+     * @details 失败的段由后台线程在下一轮重试，之后的写入恢复正常；
+     *          已丢弃的区间在文件中保留为空字节
+     */
+    uint64_t droppedBytes() const override { return droppedBytes_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief 映射区写入即对页缓存可见；Fdatasync 级别下 msync 所有已映射的段，
+     *        再对文件做 fdatasync，覆盖上次提交后已写满并解除映射的段
+     */
+    void commit(FileDurability durability) override {
+        if (durability != FileDurability::Fdatasync) return;
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto& slot : slots_) {
+            if (slot.index.load(std::memory_order_acquire) != NONE) {
+                msync(slot.base, segmentSize_, MS_SYNC);
+            }
+        }
+        if (fd_ >= 0) LogFileIO::syncData(fd_);
+    }
+
+private:
+    static constexpr uint64_t NONE = ~uint64_t(0); ///< 空槽位标记
+
+    /**
+     * @brief 映射槽位
+     */
+    struct Slot {
+        std::atomic<uint64_t> index;     ///< 映射的段序号（NONE 表示空）
+        std::atomic<uint64_t> failed;    ///< 最近一次映射失败的段序号（NONE 表示无）
+        char* base;                      ///< 映射地址
+        std::atomic<size_t> committed;   ///< 段内已写入字节数
+    };
+
+    static size_t pageSize() {
+        static const size_t size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        return size;
+    }
+
+    static size_t roundToPage(size_t n) {
+        const size_t page = pageSize();
+        return n < page ? page : (n + page - 1) / page * page;
+    }
+
+    /**
+     * @brief 等待段 index 被映射或映射失败
+     * @return 段所在槽位；槽位的 index 不等于 index 时表示映射失败，调用方丢弃数据
+     */
+    Slot* waitSlot(uint64_t index) {
+        Slot& slot = slots_[index % SLOTS];
+        auto settled = [&] {
+            return slot.index.load(std::memory_order_acquire) == index ||
+                   slot.failed.load(std::memory_order_acquire) == index;
+        };
+        if (settled()) return &slot;
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.notify_one();
+        slotCv_.wait(lock, settled);
+        return &slot;
+    }
+
+    /**
+     * @brief 回收已写满的段并映射后续段（调用方需持有 mutex_）
+     */
+    void mapAhead() {
+        for (;;) {
+            Slot& slot = slots_[nextToMap_ % SLOTS];
+            if (slot.failed.load(std::memory_order_relaxed) == nextToMap_) {
+                // 上次映射失败的段：写入方已全部放弃时跳过，否则重试映射
+                if (slot.committed.load(std::memory_order_acquire) >= segmentSize_) {
+                    slot.failed.store(NONE, std::memory_order_relaxed);
+                    ++nextToMap_;
+                    continue;
+                }
+            } else if (slot.index.load(std::memory_order_acquire) != NONE) {
+                if (slot.committed.load(std::memory_order_acquire) < segmentSize_) return;
+                munmap(slot.base, segmentSize_);
+                slot.index.store(NONE, std::memory_order_relaxed);
+                slot.committed.store(0, std::memory_order_relaxed);
+            } else if (nextToMap_ == 0) {
+                // 第 0 段开头是文件中已有的内容
+                const uint64_t existing = offset_.load() - base_;
+                slot.committed.store(static_cast<size_t>(std::min<uint64_t>(existing, segmentSize_)),
+                                     std::memory_order_relaxed);
+            }
+
+            const uint64_t start = base_ + nextToMap_ * segmentSize_;
+            // 预先分配磁盘空间，避免写入稀疏区域时因磁盘已满触发 SIGBUS
+            #ifdef __linux__
+            const bool extended = posix_fallocate(fd_, static_cast<off_t>(start),
+                                                  static_cast<off_t>(segmentSize_)) == 0;
+            #else
+            const bool extended = ftruncate(fd_, static_cast<off_t>(start + segmentSize_)) == 0;
+            #endif
+            void* addr = extended ? mmap(nullptr, segmentSize_, PROT_READ | PROT_WRITE, MAP_SHARED,
+                                         fd_, static_cast<off_t>(start))
+                                  : MAP_FAILED;
+            if (addr == MAP_FAILED) {
+                // 等待该段的写入方丢弃数据后返回；后台线程下一轮重试本段
+                slot.failed.store(nextToMap_, std::memory_order_release);
+                slotCv_.notify_all();
+                return;
+            }
+
+            slot.base = static_cast<char*>(addr);
+            slot.failed.store(NONE, std::memory_order_relaxed);
+            slot.index.store(nextToMap_, std::memory_order_release);
+            slotCv_.notify_all();
+            ++nextToMap_;
+        }
+    }
+
+    /**
+     * @brief 后台映射线程
+     */
+    void run() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (!stop_) {
+            mapAhead();
+            cv_.wait_for(lock, std::chrono::milliseconds(10));
+        }
+    }
+
+    /**
+     * @brief 解除全部映射并把文件截断到实际长度
+     */
+    void closeMappings(uint64_t length) {
+        for (auto& slot : slots_) {
+            if (slot.index.load() != NONE) {
+                munmap(slot.base, segmentSize_);
+                slot.index.store(NONE);
+            }
+        }
+        if (ftruncate(fd_, static_cast<off_t>(length)) != 0) {
+            // 截断失败只会留下尾部的空字节，不影响已写入的日志
+        }
+        ::close(fd_);
+        fd_ = -1;
+    }
+
+    const size_t segmentSize_;           ///< 段大小
+    int fd_;                             ///< 文件描述符
+    uint64_t base_;                      ///< 第 0 段在文件中的起点（页对齐）
+    std::atomic<uint64_t> offset_;       ///< 下一次写入的文件偏移（写入方原子预留）
+    Slot slots_[SLOTS];                  ///< 映射槽位
+    uint64_t nextToMap_;                 ///< 下一个待映射的段序号（受 mutex_ 保护）
+    std::mutex mutex_;                   ///< 保护映射/解除映射
+    std::condition_variable cv_;         ///< 唤醒后台映射线程
+    std::condition_variable slotCv_;     ///< 段映射完成或失败时唤醒写入方
+    std::thread thread_;                 ///< 后台映射线程
+    bool stop_;                          ///< 通知后台线程退出
+    std::atomic<uint64_t> droppedBytes_; ///< 映射失败时丢弃的字节数
+};
+#endif
+
+/**
+ * @brief 渲染后的日志行
+ * @details 由 LogRenderer 生成，text 为不带颜色的完整行（含换行符），
+ *          [levelBegin, levelEnd) 为级别文本在 text 中的位置，供控制台拼接颜色码；
+ *          所有视图仅在一次 LogSink::consume() 调用期间有效
+ */
+struct LogLine {
+    LogLevel level;            ///< 日志级别
+    int line;                  ///< 源代码行号
+    const char* file;          ///< 源文件名（带调用点描述符时不含目录，否则为调用方传入的原样）
+    std::time_t time;          ///< 记录产生时间（秒）
+    uint32_t nanos;            ///< 记录产生时间的秒内纳秒数
+    uint64_t sequence;         ///< 全局序号（0 表示未启用）
+    std::string_view message;  ///< 消息正文（延迟格式化的记录已解码）
+    std::string_view text;     ///< 完整日志行：YYYY-MM-DD HH:MM:SS [LEVEL] file:line - message\n
+    size_t levelBegin;         ///< 级别文本在 text 中的起始位置
+    size_t levelEnd;           ///< 级别文本在 text 中的结束位置
+    const LogSite* site;       ///< 调用点描述符（可能为空）
+};
+
+/**
+ * @brief 日志行渲染器
+ * @details 把一批 LogRecord 依次渲染进同一块文本缓冲区，每条记录只格式化一次，
+ *          之后所有 sink 共享这份字节。非线程安全：同步模式下每个调用线程、
+ *          异步模式下后台线程各自持有一个
+ */
+class LogRenderer {
+public:
+    LogRenderer() : minuteStart_(0), minuteCached_(false), timeLen_(0) {
+        std::memset(timeStr_, 0, sizeof(timeStr_));
+    }
+
+    /**
+     * @brief 渲染一条记录并追加到当前批次
+     * @param record 日志记录
+     * @param precision 时间戳精度
+     * @param zone 时间戳使用的时区
+     */
+    void append(const LogRecord& record, TimePrecision precision = TimePrecision::Seconds,
+                TimeZoneMode zone = TimeZoneMode::Local) {
+        if (zone != zone_.mode()) {
+            zone_.setMode(zone);
+            minuteCached_ = false;
+        }
+        formatTime(record.time, record.nanos, precision);
+
+        Offsets offsets;
+        offsets.begin = text_.size();
+        text_.append(timeStr_, timeLen_);
+        if (record.sequence != 0) {
+            char seq[24];
+            auto seqEnd = std::to_chars(seq, seq + sizeof(seq), record.sequence).ptr;
+            text_.append(" #").append(seq, seqEnd);
+        }
+        // 带调用点描述符的记录使用编译期截好的文件名，其余记录按调用方传入的原样输出
+        const char* file = record.site ? record.site->file : record.file;
+        LogSitePrefix* prefix = record.site ? record.site->prefix : nullptr;
+        if (prefix && prefix->ensure(*record.site)) {
+            // 调用点前缀已缓存：整段复制
+            offsets.levelBegin = text_.size() - offsets.begin + LogSitePrefix::LEVEL_POS;
+            offsets.levelEnd = offsets.levelBegin + prefix->levelLength();
+            text_.append(prefix->plain());
+        } else {
+            char lineNo[16];
+            auto res = std::to_chars(lineNo, lineNo + sizeof(lineNo), record.line);
+            text_.append(" [");
+            offsets.levelBegin = text_.size() - offsets.begin;
+            text_.append(logLevelToString(record.level));
+            offsets.levelEnd = text_.size() - offsets.begin;
+            text_.append("] ").append(file).append(":").append(lineNo, res.ptr).append(" - ");
+        }
+
+        // 延迟格式化的记录直接解码到输出缓冲区
+        offsets.message = text_.size();
+        if (record.encoded) {
+            LogArgCodec::decode(record.message, record.length, text_);
+        } else {
+            text_.append(record.message, record.length);
+        }
+        offsets.messageEnd = text_.size();
+        text_.push_back('\n');
+
+        lines_.push_back(LogLine{record.level, record.line, file, record.time, record.nanos,
+                                 record.sequence, {}, {}, offsets.levelBegin, offsets.levelEnd, record.site});
+        offsets_.push_back(offsets);
+    }
+
+    /**
+     * @brief 获取当前批次的日志行（文本缓冲区不再增长后调用）
+     */
+    std::span<const LogLine> lines() {
+        for (size_t i = 0; i < lines_.size(); ++i) {
+            const Offsets& o = offsets_[i];
+            const size_t end = (i + 1 < offsets_.size()) ? offsets_[i + 1].begin : text_.size();
+            lines_[i].message = std::string_view(text_.data() + o.message, o.messageEnd - o.message);
+            lines_[i].text = std::string_view(text_.data() + o.begin, end - o.begin);
+        }
+        return lines_;
+    }
+
+    /**
+     * @brief 清空当前批次（保留已分配的内存）
+     */
+    void clear() {
+        text_.clear();
+        lines_.clear();
+        offsets_.clear();
+    }
+
+    size_t size() const { return lines_.size(); }   ///< 当前批次的行数
+    size_t bytes() const { return text_.size(); }   ///< 当前批次的字节数
+
+private:
+    /**
+     * @brief 一行在 text_ 中的位置（text_ 扩容后视图会失效，因此先记偏移）
+     */
+    struct Offsets {
+        size_t begin;        ///< 行起始偏移
+        size_t levelBegin;   ///< 级别文本相对行首的起始位置
+        size_t levelEnd;     ///< 级别文本相对行首的结束位置
+        size_t message;      ///< 消息正文起始偏移
+        size_t messageEnd;   ///< 消息正文结束偏移
+    };
+
+    static constexpr size_t SECONDS_POS = 17;  ///< "YYYY-MM-DD HH:MM:" 之后秒字段的位置
+    static constexpr size_t FRACTION_POS = 19; ///< 小数点的位置
+
+    /**
+     * @brief 两位十进制数字表，DIGIT_PAIRS[2n], DIGIT_PAIRS[2n+1] 为 n 的两位数字
+     */
+    static constexpr char DIGIT_PAIRS[] =
+        "00010203040506070809101112131415161718192021222324"
+        "25262728293031323334353637383940414243444546474849"
+        "50515253545556575859606162636465666768697071727374"
+        "75767778798081828384858687888990919293949596979899";
+
+    /**
+     * @brief 把 value 以 digits 位定宽十进制写到 end 之前（按两位一组查表）
+     */
+    static void writeDigits(char* end, uint32_t value, int digits) {
+        while (digits >= 2) {
+            const uint32_t pair = value % 100;
+            value /= 100;
+            end -= 2;
+            std::memcpy(end, &DIGIT_PAIRS[pair * 2], 2);
+            digits -= 2;
+        }
+        if (digits == 1) {
+            *--end = static_cast<char>('0' + value % 10);
+        }
+    }
+
+    /**
+     * @brief 更新时间字符串缓存
+     * @details "YYYY-MM-DD HH:MM:" 前缀按分钟缓存，只在跨分钟时由 LogTimeZone 换算一次
+     *          并用整数运算拼出；秒和小数部分每条记录用两位数字表直接改写
+     */
+    void formatTime(std::time_t t, uint32_t nanos, TimePrecision precision) {
+        if (!minuteCached_ || t < minuteStart_ || t >= minuteStart_ + 60) {
+            const LogTimeZone::Civil c = zone_.toCivil(t);
+            writeDigits(timeStr_ + 4, static_cast<uint32_t>(c.year), 4);
+            timeStr_[4] = '-';
+            writeDigits(timeStr_ + 7, c.month, 2);
+            timeStr_[7] = '-';
+            writeDigits(timeStr_ + 10, c.day, 2);
+            timeStr_[10] = ' ';
+            writeDigits(timeStr_ + 13, c.hour, 2);
+            timeStr_[13] = ':';
+            writeDigits(timeStr_ + 16, c.minute, 2);
+            timeStr_[16] = ':';
+            minuteStart_ = t - c.second;
+            minuteCached_ = true;
+        }
+
+        writeDigits(timeStr_ + SECONDS_POS + 2, static_cast<uint32_t>(t - minuteStart_), 2);
+
+        static constexpr int FRACTION_DIGITS[] = {0, 3, 6, 9};
+        static constexpr uint32_t FRACTION_DIVISORS[] = {1, 1000000, 1000, 1};
+        const int index = static_cast<int>(precision);
+        const int digits = FRACTION_DIGITS[index];
+        timeLen_ = FRACTION_POS;
+        if (digits > 0) {
+            timeStr_[FRACTION_POS] = '.';
+            timeLen_ = FRACTION_POS + 1 + digits;
+            writeDigits(timeStr_ + timeLen_, nanos / FRACTION_DIVISORS[index], digits);
+        }
+        if (zone_.mode() == TimeZoneMode::Utc) {
+            timeStr_[timeLen_++] = 'Z';
+        }
+    }
+
+    std::string text_;              ///< 当前批次所有行的文本
+    std::vector<LogLine> lines_;    ///< 当前批次的日志行
+    std::vector<Offsets> offsets_;  ///< 与 lines_ 一一对应的偏移
+    std::time_t minuteStart_;       ///< 缓存前缀对应分钟的起始时间
+    bool minuteCached_;             ///< 前缀缓存是否有效
+    LogTimeZone zone_;              ///< 时间戳时区换算
+    size_t timeLen_;                ///< timeStr_ 的有效长度
+    char timeStr_[40];              ///< 格式化后的时间字符串缓存
+};
+
+/**
+ * @brief 日志输出目标（sink）
+ * @details 每个 sink 有独立的最低级别和互斥锁：Logger 只把不低于该级别的日志行交给它，
+ *          并在它自己的锁内调用 write()，一个慢速 sink 不会占用其他 sink 的锁。
+ *          自定义输出目标继承本类实现 write()，通过 Logger::addSink() 注册
+ */
+class LogSink {
+public:
+    LogSink() : level_(LogLevel::DEBUG) {}
+    virtual ~LogSink() = default;
+
+    LogSink(const LogSink&) = delete;
+    LogSink& operator=(const LogSink&) = delete;
+
+    /**
+     * @brief 设置本 sink 接收的最低级别（与 Logger::setLevel 叠加生效）
+     */
+    void setLevel(LogLevel level) {
+        level_.store(level, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief 获取本 sink 接收的最低级别
+     */
+    LogLevel getLevel() const {
+        return level_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief 是否接收该级别的日志
+     */
+    bool accepts(LogLevel level) const {
+        return level >= getLevel();
+    }
+
+    /**
+     * @brief 批量写出入口，在本 sink 的锁内调用 write()
+     * @param lines 已渲染的日志行（均不低于本 sink 的级别），仅在调用期间有效
+     */
+    void consume(std::span<const LogLine> lines) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        write(lines);
+    }
+
+    /**
+     * @brief 提交缓冲中的数据（drain() 及异步模式排空后调用）
+     */
+    void flush() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        commit();
+    }
+
+    /**
+     * @brief 执行按时间触发的提交（异步模式后台线程空闲时调用）
+     */
+    void flushIfDue() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        commitIfDue();
+    }
+
+protected:
+    /**
+     * @brief 写出一批日志行（持有 mutex_ 时调用）
+     */
+    virtual void write(std::span<const LogLine> lines) = 0;
+
+    /**
+     * @brief 提交缓冲数据（持有 mutex_ 时调用）
+     */
+    virtual void commit() {}
+
+    /**
+     * @brief 按时间阈值提交（持有 mutex_ 时调用）
+     */
+    virtual void commitIfDue() {}
+
+    std::mutex mutex_;  ///< 本 sink 的互斥锁，write/commit 及配置修改均在锁内进行
+
+private:
+    std::atomic<LogLevel> level_; ///< 本 sink 接收的最低级别
+};
+
+/**
+ * @brief 控制台输出（彩色）
+ * @details 直接写出渲染好的字节，颜色码作为独立片段拼接在级别文本两侧；
+ *          按片段写入 stdout 而不是重新格式化，保留 stdio 的缓冲方式（终端行缓冲、重定向全缓冲）
+ */
+class ConsoleSink : public LogSink {
+protected:
+    void write(std::span<const LogLine> lines) override {
+        static constexpr char reset[] = "\033[0m";
+        FILE* out = stdout;
+
+#ifdef _WIN32
+        _lock_file(out);
+#else
+        flockfile(out);
+#endif
+        for (const LogLine& line : lines) {
+            const char* data = line.text.data();
+            const LogSitePrefix* prefix = line.site ? line.site->prefix : nullptr;
+            if (prefix && prefix->ready()) {
+                // 调用点已缓存带颜色的前缀：时间戳、前缀、正文三段写出
+                const size_t prefixBegin = line.levelBegin - LogSitePrefix::LEVEL_POS;
+                const size_t messageBegin = static_cast<size_t>(line.message.data() - data);
+                const std::string_view colored = prefix->colored();
+                fwrite(data, 1, prefixBegin, out);
+                fwrite(colored.data(), 1, colored.size(), out);
+                fwrite(data + messageBegin, 1, line.text.size() - messageBegin, out);
+                continue;
+            }
+            const char* color = logLevelToColorCode(line.level);
+            fwrite(data, 1, line.levelBegin, out);
+            fwrite(color, 1, std::strlen(color), out);
+            fwrite(data + line.levelBegin, 1, line.levelEnd - line.levelBegin, out);
+            fwrite(reset, 1, sizeof(reset) - 1, out);
+            fwrite(data + line.levelEnd, 1, line.text.size() - line.levelEnd, out);
+        }
+#ifdef _WIN32
+        _unlock_file(out);
+#else
+        funlockfile(out);
+#endif
+    }
+};
+
+/**
+ * @brief 轮转文件的后台压缩配置
+ */
+struct FileCompression {
+    bool enabled = false;       ///< 是否压缩轮转下来的文件（需启用 zlib）
+    int level = 6;              ///< 压缩级别（1-9）
+    size_t threads = 0;         ///< 并行压缩线程数，0 表示硬件线程数的一半（至少 1）
+    size_t chunkSize = 1 << 20; ///< 分块大小（不小于 32 KiB 的窗口）
+};
+
+/**
+ * @brief 轮转文件的后台压缩器（gzip 格式，按块并行）
+ * @details 与 pigz 相同的做法：文件按 chunkSize 分块，各块由压缩线程与常驻的辅助线程并行用 raw deflate 压缩，
+ *          以前一块末尾 32 KiB 作为预置字典保持压缩率；非末块以 Z_SYNC_FLUSH 字节对齐结束，
+ *          按顺序拼接后即为一个完整的 deflate 流，CRC 用 crc32_combine 合并。
+ *          每批只读入 threads 个块，压缩与辅助线程降低调度优先级，避免一次性读完大文件造成 I/O 尖峰。
+ *          先写入 .gz.tmp，完成后改名为 .gz 并删除原文件；失败时保留原文件。
+ *          析构时不再接受新文件，但会处理完队列中已提交的文件后才返回。
+ *          未启用 zlib（LOGGER_WITH_ZLIB）时提交的文件保持原样
+ */
+class LogCompressor {
+public:
+    static constexpr size_t WINDOW = 32 * 1024; ///< deflate 窗口大小（预置字典长度）
+
+    LogCompressor() : busy_(false), stop_(false) {}
+
+    /**
+     * @brief 停止接受新文件，处理完已提交的文件后退出压缩线程
+     */
+    ~LogCompressor() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        cv_.notify_all();
+        if (thread_.joinable()) {
+            thread_.join();
+        }
+    }
+
+    /**
+     * @brief 是否支持压缩（编译时启用了 zlib）
+     */
+    static bool available() {
+        #ifdef LOGGER_HAS_ZLIB
+        return true;
+        #else
+        return false;
+        #endif
+    }
+
+    /**
+     * @brief 设置压缩配置，对之后提交的文件生效
+     */
+    void setConfig(const FileCompression& config) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        config_ = config;
+    }
+
+    /**
+     * @brief 获取压缩配置
+     */
+    FileCompression getConfig() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return config_;
+    }
+
+    /**
+     * @brief 设置处理完一个文件后的回调，参数为最终留在磁盘上的文件（.gz 或压缩失败时的原文件）
+     * @details 在压缩线程中调用；需在提交文件前设置
+     */
+    void setOnDone(std::function<void(const std::string&)> onDone) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        onDone_ = std::move(onDone);
+    }
+
+    /**
+     * @brief 提交一个已关闭的文件
+     * @return 是否接受（未启用压缩时返回 false，文件保持原样）
+     */
+    bool submit(const std::string& path) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!config_.enabled || !available() || stop_) return false;
+            queue_.push_back(path);
+            if (!thread_.joinable()) {
+                thread_ = std::thread(&LogCompressor::run, this);
+            }
+        }
+        cv_.notify_all();
+        return true;
+    }
+
+    /**
+     * @brief 等待已提交的文件全部处理完
+     */
+    void wait() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [this] { return queue_.empty() && !busy_; });
+    }
+
+private:
+    /**
+     * @brief 降低当前线程的调度优先级（Linux 上 nice 值按线程生效，I/O 优先级随之降低）
+     */
+    static void lowerPriority() {
+        #ifdef __linux__
+        setpriority(PRIO_PROCESS, 0, 19);
+        #endif
+    }
+
+    /**
+     * @brief 压缩线程：逐个处理提交的文件，停止时先处理完队列
+     */
+    void run() {
+        lowerPriority();
+        std::unique_lock<std::mutex> lock(mutex_);
+        for (;;) {
+            cv_.wait(lock, [this] { return stop_ || !queue_.empty(); });
+            if (queue_.empty()) break;
+
+            std::string path = std::move(queue_.front());
+            queue_.erase(queue_.begin());
+            FileCompression config = config_;
+            busy_ = true;
+            lock.unlock();
+            const bool compressed = compressFile(path, config);
+            if (onDone_) {
+                onDone_(compressed ? path + ".gz" : path);
+            }
+            lock.lock();
+            busy_ = false;
+            cv_.notify_all();
+        }
+        #ifdef LOGGER_HAS_ZLIB
+        lock.unlock();
+        resizePool(0);
+        #endif
+    }
+
+#ifdef LOGGER_HAS_ZLIB
+    /**
+     * @brief 一个分块的压缩任务
+     */
+    struct Chunk {
+        const unsigned char* dict; ///< 预置字典（前一块末尾）
+        size_t dictLength;         ///< 预置字典长度
+        const unsigned char* data; ///< 块数据
+        size_t length;             ///< 块长度
+        bool last;                 ///< 是否为文件最后一块
+        std::string out;           ///< 压缩结果
+        uLong crc;                 ///< 块数据的 CRC32
+        bool ok;                   ///< 是否压缩成功
+    };
+
+    /**
+     * @brief 用 raw deflate 压缩一个分块
+     */
+    static void deflateChunk(Chunk& chunk, int level) {
+        chunk.crc = crc32(crc32(0, nullptr, 0), chunk.data, static_cast<uInt>(chunk.length));
+        chunk.ok = false;
+
+        z_stream zs;
+        std::memset(&zs, 0, sizeof(zs));
+        if (deflateInit2(&zs, level, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY) != Z_OK) return;
+        if (chunk.dictLength != 0) {
+            deflateSetDictionary(&zs, chunk.dict, static_cast<uInt>(chunk.dictLength));
+        }
+
+        // Z_SYNC_FLUSH 额外输出不超过几个字节，留出余量后一次调用即可完成
+        chunk.out.resize(deflateBound(&zs, static_cast<uLong>(chunk.length)) + 64);
+        zs.next_in = const_cast<Bytef*>(chunk.data);
+        zs.avail_in = static_cast<uInt>(chunk.length);
+        zs.next_out = reinterpret_cast<Bytef*>(chunk.out.data());
+        zs.avail_out = static_cast<uInt>(chunk.out.size());
+        int rc = deflate(&zs, chunk.last ? Z_FINISH : Z_SYNC_FLUSH);
+        chunk.ok = chunk.last ? rc == Z_STREAM_END : (rc == Z_OK && zs.avail_in == 0 && zs.avail_out != 0);
+        chunk.out.resize(zs.total_out);
+        deflateEnd(&zs);
+    }
+
+    /**
+     * @brief 把 chunks 中的各块分给当前线程与辅助线程压缩，全部完成后返回
+     * @details 只在压缩线程中调用
+     */
+    void deflateChunks(std::vector<Chunk>& chunks, int level, size_t helpers) {
+        resizePool(helpers);
+        std::unique_lock<std::mutex> lock(poolMutex_);
+        poolChunks_ = &chunks;
+        poolLevel_ = level;
+        poolNext_ = 0;
+        poolPending_ = chunks.size();
+        if (chunks.size() > 1) poolCv_.notify_all();
+        takeChunks(lock);
+        poolDoneCv_.wait(lock, [this] { return poolPending_ == 0; });
+        poolChunks_ = nullptr;
+    }
+
+    /**
+     * @brief 领取并压缩当前批次中尚未领取的块（调用方持有 poolMutex_）
+     */
+    void takeChunks(std::unique_lock<std::mutex>& lock) {
+        while (poolChunks_ && poolNext_ < poolChunks_->size()) {
+            Chunk& chunk = (*poolChunks_)[poolNext_++];
+            const int level = poolLevel_;
+            lock.unlock();
+            deflateChunk(chunk, level);
+            lock.lock();
+            if (--poolPending_ == 0) poolDoneCv_.notify_all();
+        }
+    }
+
+    /**
+     * @brief 辅助线程：等待压缩线程发布批次并领取其中的块
+     */
+    void helperLoop() {
+        lowerPriority();
+        std::unique_lock<std::mutex> lock(poolMutex_);
+        for (;;) {
+            poolCv_.wait(lock, [this] {
+                return poolStop_ || (poolChunks_ && poolNext_ < poolChunks_->size());
+            });
+            if (poolStop_) return;
+            takeChunks(lock);
+        }
+    }
+
+    /**
+     * @brief 把常驻辅助线程数调整为 count（只在压缩线程中调用）
+     */
+    void resizePool(size_t count) {
+        if (helpers_.size() == count) return;
+        {
+            std::lock_guard<std::mutex> lock(poolMutex_);
+            poolStop_ = true;
+        }
+        poolCv_.notify_all();
+        for (std::thread& helper : helpers_) {
+            helper.join();
+        }
+        helpers_.clear();
+        poolStop_ = false;
+        for (size_t i = 0; i < count; ++i) {
+            helpers_.emplace_back(&LogCompressor::helperLoop, this);
+        }
+    }
+
+    /**
+     * @brief 写出 32 位小端整数
+     */
+    static void putLe32(unsigned char* p, uint32_t v) {
+        p[0] = static_cast<unsigned char>(v);
+        p[1] = static_cast<unsigned char>(v >> 8);
+        p[2] = static_cast<unsigned char>(v >> 16);
+        p[3] = static_cast<unsigned char>(v >> 24);
+    }
+#endif
+
+    /**
+     * @brief 把 path 压缩为 path.gz 并删除原文件
+     * @return 是否压缩成功
+     */
+    bool compressFile(const std::string& path, const FileCompression& config) {
+        #ifdef LOGGER_HAS_ZLIB
+        const size_t threads = config.threads != 0
+            ? config.threads
+            : std::max<size_t>(1, std::thread::hardware_concurrency() / 2);
+        const size_t chunkSize = std::max(config.chunkSize, WINDOW);
+        const size_t batchSize = threads * chunkSize;
+        const std::string target = path + ".gz";
+        const std::string temp = target + ".tmp";
+
+        FILE* in = std::fopen(path.c_str(), "rb");
+        if (!in) return false;
+        FILE* out = std::fopen(temp.c_str(), "wb");
+        if (!out) {
+            std::fclose(in);
+            return false;
+        }
+
+        // gzip 头：无文件名、mtime 为 0、OS 未知
+        static constexpr unsigned char header[10] = {0x1f, 0x8b, 8, 0, 0, 0, 0, 0, 0, 0xff};
+        bool ok = std::fwrite(header, 1, sizeof(header), out) == sizeof(header);
+
+        // 缓冲区前 WINDOW 字节保存上一批的末尾，作为本批第一块的字典
+        std::vector<unsigned char> buffer(WINDOW + batchSize);
+        std::vector<Chunk> chunks;
+        size_t dictLength = 0;
+        uLong crc = crc32(0, nullptr, 0);
+        uint64_t total = 0;
+
+        size_t n = std::fread(buffer.data() + WINDOW, 1, batchSize, in);
+        while (ok) {
+            bool last = n < batchSize;
+            if (!last) {
+                int c = std::fgetc(in);
+                last = c == EOF;
+                if (!last) std::ungetc(c, in);
+            }
+
+            const size_t count = std::max<size_t>(1, (n + chunkSize - 1) / chunkSize);
+            chunks.assign(count, Chunk{});
+            for (size_t i = 0; i < count; ++i) {
+                Chunk& chunk = chunks[i];
+                chunk.data = buffer.data() + WINDOW + i * chunkSize;
+                chunk.length = std::min(chunkSize, n - std::min(n, i * chunkSize));
+                chunk.dict = chunk.data - (i == 0 ? dictLength : WINDOW);
+                chunk.dictLength = i == 0 ? dictLength : WINDOW;
+                chunk.last = last && i + 1 == count;
+            }
+
+            // 当前线程与 threads - 1 个常驻辅助线程一起领取各块
+            deflateChunks(chunks, config.level, threads - 1);
+
+            for (const Chunk& chunk : chunks) {
+                ok = ok && chunk.ok &&
+                     std::fwrite(chunk.out.data(), 1, chunk.out.size(), out) == chunk.out.size();
+                crc = crc32_combine(crc, chunk.crc, static_cast<z_off_t>(chunk.length));
+            }
+            total += n;
+            if (last) break;
+
+            std::memcpy(buffer.data(), buffer.data() + n, WINDOW);
+            dictLength = WINDOW;
+            n = std::fread(buffer.data() + WINDOW, 1, batchSize, in);
+        }
+
+        // gzip 尾：CRC32 与原始长度（模 2^32）
+        unsigned char trailer[8];
+        putLe32(trailer, static_cast<uint32_t>(crc));
+        putLe32(trailer + 4, static_cast<uint32_t>(total));
+        ok = ok && std::fwrite(trailer, 1, sizeof(trailer), out) == sizeof(trailer);
+        ok = ok && !std::ferror(in);
+        std::fclose(in);
+        ok = std::fclose(out) == 0 && ok;
+
+        if (!ok || std::rename(temp.c_str(), target.c_str()) != 0) {
+            std::remove(temp.c_str());
+            return false;
+        }
+        std::remove(path.c_str());
+        return true;
+        #else
+        (void)path;
+        (void)config;
+        return false;
+        #endif
+    }
+
+    std::mutex mutex_;                ///< 保护以下成员
+    std::condition_variable cv_;      ///< 唤醒压缩线程 / 通知处理完成
+    std::thread thread_;              ///< 压缩线程（首次提交时启动）
+    std::vector<std::string> queue_;  ///< 待压缩的文件
+    FileCompression config_;          ///< 压缩配置
+    std::function<void(const std::string&)> onDone_; ///< 处理完一个文件后的回调
+    bool busy_;                       ///< 正在压缩文件
+    bool stop_;                       ///< 通知压缩线程处理完队列后退出
+
+#ifdef LOGGER_HAS_ZLIB
+    // 以下成员只由压缩线程与辅助线程使用
+    std::vector<std::thread> helpers_;      ///< 常驻辅助压缩线程（压缩首个文件时启动）
+    std::mutex poolMutex_;                  ///< 保护以下批次状态
+    std::condition_variable poolCv_;        ///< 唤醒辅助线程领取新批次
+    std::condition_variable poolDoneCv_;    ///< 通知压缩线程本批次已完成
+    std::vector<Chunk>* poolChunks_ = nullptr; ///< 当前批次（无批次时为空）
+    int poolLevel_ = 0;                     ///< 当前批次的压缩级别
+    size_t poolNext_ = 0;                   ///< 下一个待领取的块
+    size_t poolPending_ = 0;                ///< 尚未压缩完的块数
+    bool poolStop_ = false;                 ///< 通知辅助线程退出
+#endif
+};
+
+/**
+ * @brief 已轮转文件的保留策略
+ * @details 三项预算任一超出时从最旧的文件开始删除（按最后修改时间排序）；
+ *          只统计已轮转下来的文件（含压缩后的 .gz），不包括正在写入的文件与空的预备文件
+ */
+struct FileRetention {
+    size_t maxFiles = 0;           ///< 最多保留的文件数，0 表示不限制
+    std::chrono::hours maxAge{0};  ///< 最长保留时间，0 表示不限制
+    uint64_t maxTotalBytes = 0;    ///< 总字节数上限，0 表示不限制
+};
+
+/**
+ * @brief 已轮转文件的保留管理器
+ * @details 首次执行（或文件名模式变更）时扫描一次目录建立索引，之后只按轮转/压缩通知增量更新，
+ *          不在每次轮转时重新扫描目录。删除在后台线程中进行，大文件的 unlink 不会阻塞写日志的线程；
+ *          设置了 maxAge 时在最旧文件到期时自动唤醒
+ */
+class LogRetention {
+public:
+    LogRetention() : indexed_(false), dirty_(false), busy_(false), stop_(false) {}
+
+    ~LogRetention() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        cv_.notify_all();
+        if (thread_.joinable()) {
+            thread_.join();
+        }
+    }
+
+    /**
+     * @brief 设置保留策略，立即按新策略检查一次
+     */
+    void setPolicy(const FileRetention& policy) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        policy_ = policy;
+        kick();
+    }
+
+    /**
+     * @brief 获取保留策略
+     */
+    FileRetention getPolicy() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return policy_;
+    }
+
+    /**
+     * @brief 设置管理的文件名前缀（如 /var/log/app-），变更时重建索引
+     */
+    void setPattern(const std::string& prefix) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (prefix != prefix_) {
+            prefix_ = prefix;
+            indexed_ = false;
+        }
+        kick();
+    }
+
+    /**
+     * @brief 设置正在写入的文件，该文件不会被删除
+     */
+    void setActive(const std::string& path) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        active_ = path;
+    }
+
+    /**
+     * @brief 通知一个文件已轮转下来（或已压缩完成）
+     */
+    void add(const std::string& path) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        // 轮转通知可能早于新文件的 setActive，已轮转下来的文件不再受保护
+        if (active_ == path) {
+            active_.clear();
+        }
+        if (!enabled()) return;
+        pending_.push_back(path);
+        kick();
+    }
+
+    /**
+     * @brief 等待已通知的文件全部处理完
+     */
+    void wait() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [this] { return !dirty_ && !busy_; });
+    }
+
+private:
+    /**
+     * @brief 索引中的一个文件
+     */
+    struct Entry {
+        std::string path;                         ///< 文件路径
+        uint64_t size;                            ///< 文件大小
+        std::filesystem::file_time_type mtime;    ///< 最后修改时间
+    };
+
+    /**
+     * @brief 是否设置了任一预算（调用方需持有 mutex_）
+     */
+    bool enabled() const {
+        return policy_.maxFiles != 0 || policy_.maxAge.count() != 0 || policy_.maxTotalBytes != 0;
+    }
+
+    /**
+     * @brief 标记需要检查并唤醒后台线程（调用方需持有 mutex_）
+     */
+    void kick() {
+        if (!enabled() || prefix_.empty() || stop_) return;
+        dirty_ = true;
+        if (!thread_.joinable()) {
+            thread_ = std::thread(&LogRetention::run, this);
+        }
+        cv_.notify_all();
+    }
+
+    /**
+     * @brief 文件名是否属于前缀对应的日志文件：前缀 + 日期 + (.序号).log(.gz)
+     */
+    static bool matches(const std::string& name, const std::string& namePrefix) {
+        if (name.size() <= namePrefix.size() || name.compare(0, namePrefix.size(), namePrefix) != 0) {
+            return false;
+        }
+        if (!std::isdigit(static_cast<unsigned char>(name[namePrefix.size()]))) return false;
+        auto endsWith = [&name](const char* suffix) {
+            const size_t n = std::strlen(suffix);
+            return name.size() >= n && name.compare(name.size() - n, n, suffix) == 0;
+        };
+        return endsWith(".log") || endsWith(".log.gz");
+    }
+
+    /**
+     * @brief 读取文件信息，不存在或为空时返回 false
+     */
+    static bool statFile(const std::string& path, Entry& entry) {
+        std::error_code ec;
+        const uint64_t size = std::filesystem::file_size(path, ec);
+        if (ec || size == 0) return false;
+        const auto mtime = std::filesystem::last_write_time(path, ec);
+        if (ec) return false;
+        entry = Entry{path, size, mtime};
+        return true;
+    }
+
+    /**
+     * @brief 扫描目录重建索引
+     */
+    void rebuild(const std::string& prefix) {
+        index_.clear();
+        const std::filesystem::path pattern(prefix);
+        const std::filesystem::path dir = pattern.parent_path();
+        const std::string namePrefix = pattern.filename().string();
+
+        std::error_code ec;
+        std::filesystem::directory_iterator it(dir.empty() ? std::filesystem::path(".") : dir, ec);
+        for (; !ec && it != std::filesystem::directory_iterator(); it.increment(ec)) {
+            const std::string name = it->path().filename().string();
+            if (!matches(name, namePrefix)) continue;
+            Entry entry;
+            if (statFile((dir / name).string(), entry)) {
+                index_.push_back(std::move(entry));
+            }
+        }
+    }
+
+    /**
+     * @brief 把通知的文件加入索引（压缩后的 .gz 替换原文件）
+     */
+    void update(const std::string& path, const std::string& prefix) {
+        if (path.compare(0, prefix.size(), prefix) != 0) return;
+        std::string original;
+        if (path.size() > 3 && path.compare(path.size() - 3, 3, ".gz") == 0) {
+            original = path.substr(0, path.size() - 3);
+        }
+        index_.erase(std::remove_if(index_.begin(), index_.end(), [&](const Entry& e) {
+            return e.path == path || e.path == original;
+        }), index_.end());
+        Entry entry;
+        if (statFile(path, entry)) {
+            index_.push_back(std::move(entry));
+        }
+    }
+
+    /**
+     * @brief 按策略从最旧的文件开始删除
+     * @return 设置了 maxAge 时距最旧文件到期的时间，否则为 max()
+     */
+    std::chrono::nanoseconds enforce(const FileRetention& policy, const std::string& active) {
+        std::sort(index_.begin(), index_.end(), [](const Entry& a, const Entry& b) {
+            return a.mtime != b.mtime ? a.mtime < b.mtime : a.path < b.path;
+        });
+
+        size_t count = 0;
+        uint64_t total = 0;
+        for (const Entry& e : index_) {
+            if (e.path == active) continue;
+            ++count;
+            total += e.size;
+        }
+
+        const auto now = std::filesystem::file_time_type::clock::now();
+        std::vector<Entry> kept;
+        bool done = false;
+        for (Entry& e : index_) {
+            if (done || e.path == active) {
+                kept.push_back(std::move(e));
+                continue;
+            }
+            const bool expire = (policy.maxFiles != 0 && count > policy.maxFiles) ||
+                                (policy.maxTotalBytes != 0 && total > policy.maxTotalBytes) ||
+                                (policy.maxAge.count() != 0 && now - e.mtime > policy.maxAge);
+            if (!expire) {
+                // 按时间排序：最旧的文件满足预算时，其余文件也满足
+                done = true;
+                kept.push_back(std::move(e));
+                continue;
+            }
+            std::error_code ec;
+            std::filesystem::remove(e.path, ec);
+            --count;
+            total -= e.size;
+        }
+        index_ = std::move(kept);
+
+        if (policy.maxAge.count() == 0) return std::chrono::nanoseconds::max();
+        for (const Entry& e : index_) {
+            if (e.path == active) continue;
+            return std::max(std::chrono::nanoseconds(0),
+                            std::chrono::duration_cast<std::chrono::nanoseconds>(e.mtime + policy.maxAge - now));
+        }
+        return std::chrono::nanoseconds::max();
+    }
+
+    /**
+     * @brief 后台线程：处理通知并执行保留策略
+     */
+    void run() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        auto deadline = std::chrono::steady_clock::time_point::max();
+        for (;;) {
+            if (deadline == std::chrono::steady_clock::time_point::max()) {
+                cv_.wait(lock, [this] { return stop_ || dirty_; });
+            } else {
+                cv_.wait_until(lock, deadline, [this] { return stop_ || dirty_; });
+            }
+            if (stop_) break;
+            if (!dirty_ && std::chrono::steady_clock::now() < deadline) continue;
+
+            std::vector<std::string> pending = std::move(pending_);
+            pending_.clear();
+            const FileRetention policy = policy_;
+            const std::string prefix = prefix_;
+            const std::string active = active_;
+            const bool rescan = !indexed_;
+            indexed_ = true;
+            dirty_ = false;
+            busy_ = true;
+            lock.unlock();
+
+            if (rescan) {
+                rebuild(prefix);
+            }
+            for (const std::string& path : pending) {
+                update(path, prefix);
+            }
+            const auto wait = enforce(policy, active);
+
+            lock.lock();
+            busy_ = false;
+            deadline = wait == std::chrono::nanoseconds::max()
+                ? std::chrono::steady_clock::time_point::max()
+                : std::chrono::steady_clock::now() + wait;
+            cv_.notify_all();
+        }
+    }
+
+    std::mutex mutex_;                ///< 保护以下共享成员（index_ 只由后台线程访问）
+    std::condition_variable cv_;      ///< 唤醒后台线程 / 通知处理完成
+    std::thread thread_;              ///< 后台线程（首次需要时启动）
+    FileRetention policy_;            ///< 保留策略
+    std::string prefix_;              ///< 管理的文件名前缀
+    std::string active_;              ///< 正在写入的文件
+    std::vector<std::string> pending_; ///< 待加入索引的文件
+    bool indexed_;                    ///< 索引是否已按当前前缀建立
+    bool dirty_;                      ///< 有待处理的通知或配置变更
+    bool busy_;                       ///< 后台线程正在处理
+    bool stop_;                       ///< 通知后台线程退出
+    std::vector<Entry> index_;        ///< 已轮转文件的索引
+};
+
+/**
+ * @brief 文件按日历轮转的周期
+ */
+enum class FileRotation {
+    Daily,   ///< 每天本地零点轮转，后缀 -YYYYMMDD.log
+    Hourly   ///< 每个整点轮转，后缀 -YYYYMMDD-HH.log
+};
+
+/**
+ * @brief 单个日志文件的大小上限
+ * @details 任一上限达到时在同一周期内切换到下一个序号的文件
+ *          （app-20260218.log -> app-20260218.1.log -> app-20260218.2.log ...）。
+ *          字节数包含打开时文件中已有的内容；记录数只统计本次打开后写入的记录
+ */
+struct FileSizeLimit {
+    uint64_t maxBytes = 0;   ///< 单个文件最大字节数，0 表示不限制
+    uint64_t maxRecords = 0; ///< 单个文件最大记录数，0 表示不限制
+};
+
+/**
+ * @brief 文件输出（按日历与大小轮转）
+ * @details 文件名在基础路径上添加日期后缀（如 app.log -> app-20260218.log），
+ *          在本地零点（或整点）切换到新文件，超过大小上限时切换到同一周期的下一个序号；
+ *          写出后端与组提交策略可独立配置。
+ *          下一个轮转时刻在打开文件时算好，写入路径上只比较记录时间与累计大小。
+ *          后台轮转线程预先打开下一个周期（到点前 standbyLead 秒）和下一个序号（立即）的文件，
+ *          并负责关闭换下来的文件，写入方切换时只需交换写入器，不在持锁期间等待 fopen/fclose。
+ *          Logger 内置一个实例（setFile 系列接口），也可另建实例作为附加 sink，
+ *          例如只接收 ERROR 的独立文件
+ */
+class FileSink : public LogSink {
+public:
+    static constexpr size_t DEFAULT_BUFFER_SIZE = 4 << 20;                  ///< 默认文件后端缓冲区大小（4 MiB）
+    static constexpr auto DEFAULT_STANDBY_LEAD = std::chrono::seconds(60); ///< 默认提前打开下一个文件的时间
+
+    FileSink()
+        : backend_(FileBackend::Stdio), bufferSize_(DEFAULT_BUFFER_SIZE), preallocate_(0),
+          rotation_(FileRotation::Daily), standbyLead_(DEFAULT_STANDBY_LEAD),
+          periodStart_(0), nextRotation_(0), index_(0), fileBytes_(0), fileRecords_(0),
+          pendingBytes_(0), requestId_(0), closing_(0), openingId_(0), rotatorStop_(false),
+          droppedBytes_(0) {
+        // 压缩完成的文件交给保留管理器
+        compressor_.setOnDone([this](const std::string& path) { retention_.add(path); });
+    }
+
+    ~FileSink() override {
+        close();
+        if (rotator_.joinable()) {
+            {
+                std::lock_guard<std::mutex> lock(rotatorMutex_);
+                rotatorStop_ = true;
+            }
+            rotatorCv_.notify_all();
+            rotator_.join();
+        }
+    }
+
+    /**
+     * @brief 打开日志文件
+     * @param basePath 基础路径，文件名会自动添加日期后缀
+     * @return 是否打开成功
+     */
+    bool open(const std::string& basePath) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        basePath_ = basePath;
+        openFile();
+        return writer_ != nullptr;
+    }
+
+    /**
+     * @brief 提交残留数据并关闭文件（等待轮转线程关闭换下来的文件）
+     */
+    void close() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        closeFile();
+        waitRetired();
+    }
+
+    /**
+     * @brief 文件是否已打开
+     */
+    bool isOpen() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return writer_ != nullptr;
+    }
+
+    /**
+     * @brief 累计因写出后端失败（映射失败、O_DIRECT 写入持续失败等）而丢弃的字节数
+     * @details 包括当前写入器与已关闭写入器的丢弃量
+     */
+    uint64_t droppedBytes() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return droppedBytes_.load(std::memory_order_relaxed) + (writer_ ? writer_->droppedBytes() : 0);
+    }
+
+    /**
+     * @brief 设置写出后端，已打开的文件按新后端重新打开
+     * @param backend 后端类型
+     * @param bufferSize 后端缓冲区大小
+     */
+    void setBackend(FileBackend backend, size_t bufferSize = DEFAULT_BUFFER_SIZE) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        backend_ = backend;
+        bufferSize_ = bufferSize;
+        if (writer_) {
+            openFile();
+        }
+    }
+
+    /**
+     * @brief 获取写出后端
+     */
+    FileBackend getBackend() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return backend_;
+    }
+
+    /**
+     * @brief 设置组提交策略，已打开的文件先提交残留数据再重新打开
+     */
+    void setCommitPolicy(const FileCommitPolicy& policy) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        policy_ = policy;
+        if (writer_) {
+            openFile();
+        }
+    }
+
+    /**
+     * @brief 获取组提交策略
+     */
+    FileCommitPolicy getCommitPolicy() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return policy_;
+    }
+
+    /**
+     * @brief 设置空间预分配步长，已打开的文件重新打开
+     * @param chunk 每次在文件末尾之后预留的字节数（如 64 MiB），0 表示不预分配
+     */
+    void setPreallocation(size_t chunk) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        preallocate_ = chunk;
+        if (writer_) {
+            openFile();
+        }
+    }
+
+    /**
+     * @brief 获取空间预分配步长
+     */
+    size_t getPreallocation() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return preallocate_;
+    }
+
+    /**
+     * @brief 设置轮转周期，已打开的文件按新的命名规则重新打开
+     * @param rotation 按天或按小时
+     * @param standbyLead 提前多久在后台打开下一个周期的文件
+     */
+    void setRotation(FileRotation rotation, std::chrono::seconds standbyLead = DEFAULT_STANDBY_LEAD) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        rotation_ = rotation;
+        standbyLead_ = standbyLead;
+        if (writer_) {
+            openFile();
+        }
+    }
+
+    /**
+     * @brief 获取轮转周期
+     */
+    FileRotation getRotation() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return rotation_;
+    }
+
+    /**
+     * @brief 设置轮转周期与文件名使用的时区，已打开的文件按新的时区重新打开
+     */
+    void setTimeZone(TimeZoneMode mode) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (mode == zone_.mode()) return;
+        zone_.setMode(mode);
+        if (writer_) {
+            openFile();
+        }
+    }
+
+    /**
+     * @brief 获取轮转周期与文件名使用的时区
+     */
+    TimeZoneMode getTimeZone() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return zone_.mode();
+    }
+
+    /**
+     * @brief 设置单个文件的大小上限，已打开的文件重新打开（已满时跳到下一个序号）
+     */
+    void setSizeLimit(const FileSizeLimit& limit) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        limit_ = limit;
+        if (writer_) {
+            openFile();
+        }
+    }
+
+    /**
+     * @brief 获取单个文件的大小上限
+     */
+    FileSizeLimit getSizeLimit() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return limit_;
+    }
+
+    /**
+     * @brief 设置轮转下来的文件的后台压缩配置
+     */
+    void setCompression(const FileCompression& compression) {
+        compressor_.setConfig(compression);
+    }
+
+    /**
+     * @brief 获取后台压缩配置
+     */
+    FileCompression getCompression() {
+        return compressor_.getConfig();
+    }
+
+    /**
+     * @brief 等待已轮转的文件关闭并压缩完成
+     */
+    void waitCompressed() {
+        waitRetired();
+        compressor_.wait();
+    }
+
+    /**
+     * @brief 设置已轮转文件的保留策略
+     */
+    void setRetention(const FileRetention& retention) {
+        retention_.setPolicy(retention);
+    }
+
+    /**
+     * @brief 获取保留策略
+     */
+    FileRetention getRetention() {
+        return retention_.getPolicy();
+    }
+
+    /**
+     * @brief 等待已轮转的文件关闭、压缩并按保留策略处理完成
+     */
+    void waitRetained() {
+        waitCompressed();
+        retention_.wait();
+    }
+
+protected:
+    void write(std::span<const LogLine> lines) override {
+        if (!writer_) return;
+
+        bool urgent = false;
+        for (const LogLine& line : lines) {
+            // 到达预先算好的轮转时刻时切换到下一个周期
+            if (line.time >= nextRotation_) {
+                rotate(line.time);
+                if (!writer_) return;
+            }
+            // 超过大小上限时切换到同一周期的下一个序号
+            if ((limit_.maxBytes != 0 && fileBytes_ != 0 && fileBytes_ + line.text.size() > limit_.maxBytes) ||
+                (limit_.maxRecords != 0 && fileRecords_ >= limit_.maxRecords)) {
+                switchTo(periodStart_, nextRotation_, index_ + 1);
+                if (!writer_) return;
+            }
+            writer_->write(line.text.data(), line.text.size());
+            pendingBytes_ += line.text.size();
+            fileBytes_ += line.text.size();
+            ++fileRecords_;
+            urgent = urgent || (line.level >= ERROR && policy_.flushOnError);
+        }
+
+        if (writer_->selfCommitting()) {
+            // 写入器自行批量写出，ERROR 记录只催促其尽快写出
+            if (urgent) {
+                writer_->requestCommit();
+            }
+        } else if (policy_.flushBytes == 0 || pendingBytes_ >= policy_.flushBytes || urgent) {
+            commitFile(urgent);
+        } else {
+            commitIfDue();
+        }
+    }
+
+    void commit() override {
+        commitFile();
+        waitRetired();
+    }
+
+    void commitIfDue() override {
+        if (pendingBytes_ == 0 || policy_.flushInterval.count() == 0) return;
+        if (writer_ && writer_->selfCommitting()) return;
+        if (std::chrono::steady_clock::now() - lastCommit_ >= policy_.flushInterval) {
+            commitFile();
+        }
+    }
+
+private:
+    /**
+     * @brief 交给轮转线程关闭的写入器
+     */
+    struct Retired {
+        std::unique_ptr<LogFileWriter> writer; ///< 待关闭的写入器
+        FileDurability durability;             ///< 关闭前的提交级别
+        std::string removeIfEmpty;             ///< 非空时关闭后若文件为空则删除（未用上的预备文件）
+        std::string rotated;                   ///< 非空时关闭后交给压缩器（轮转下来的文件）
+    };
+
+    /**
+     * @brief 预先打开的文件（请求与结果，由轮转线程处理）
+     */
+    struct Standby {
+        uint64_t id = 0;               ///< 请求编号（0 表示无请求）
+        std::time_t period = 0;        ///< 目标文件所属周期的起始时刻
+        size_t index = 0;              ///< 目标文件在周期内的序号
+        std::time_t prepareAt = 0;     ///< 最早开始打开的时刻
+        std::string path;              ///< 目标文件路径
+        FileBackend backend = FileBackend::Stdio; ///< 写出后端
+        size_t bufferSize = 0;         ///< 后端缓冲区大小
+        FileCommitPolicy policy;       ///< 组提交策略
+        size_t preallocate = 0;        ///< 空间预分配步长
+        std::unique_ptr<LogFileWriter> writer; ///< 已打开的写入器（未就绪时为空）
+        uint64_t bytes = 0;            ///< 打开时文件中已有的字节数
+        bool failed = false;           ///< 打开失败，不再重试
+    };
+
+    static constexpr size_t NEXT_PERIOD = 0; ///< 预备槽位：下一个周期的首个文件
+    static constexpr size_t NEXT_INDEX = 1;  ///< 预备槽位：当前周期的下一个序号
+
+    /**
+     * @brief 计算时刻 t 所在轮转周期的起止时间（按 zone_ 的时区）
+     */
+    void periodOf(std::time_t t, std::time_t& start, std::time_t& end) {
+        const LogTimeZone::Civil c = zone_.toCivil(t);
+        if (rotation_ == FileRotation::Hourly) {
+            start = t - c.minute * 60 - c.second;
+            end = start + 60 * 60;
+            return;
+        }
+        start = zone_.fromCivil(c.year, c.month, c.day);
+        end = zone_.fromCivil(c.year, c.month, c.day + 1);
+    }
+
+    /**
+     * @brief 周期起点与序号对应的文件路径（序号 0 不带序号后缀）
+     */
+    std::string pathFor(std::time_t periodStart, size_t index) {
+        const LogTimeZone::Civil c = zone_.toCivil(periodStart);
+        char suffix[48];
+        size_t n = static_cast<size_t>(rotation_ == FileRotation::Hourly
+            ? std::snprintf(suffix, sizeof(suffix), "-%04d%02u%02u-%02u", c.year, c.month, c.day, c.hour)
+            : std::snprintf(suffix, sizeof(suffix), "-%04d%02u%02u", c.year, c.month, c.day));
+        if (index != 0) {
+            n += std::snprintf(suffix + n, sizeof(suffix) - n, ".%zu", index);
+        }
+        std::snprintf(suffix + n, sizeof(suffix) - n, ".log");
+
+        return stem() + suffix;
+    }
+
+    /**
+     * @brief 基础路径去掉扩展名的部分，日期后缀插在其后
+     */
+    std::string stem() const {
+        size_t dotPos = basePath_.find_last_of('.');
+        if (dotPos == std::string::npos) {
+            return basePath_;
+        }
+        return basePath_.substr(0, dotPos);
+    }
+
+    /**
+     * @brief 按给定后端创建文件写入器
+     */
+    static std::unique_ptr<LogFileWriter> makeWriter(FileBackend backend, size_t bufferSize) {
+        switch (backend) {
+            case FileBackend::DoubleBuffered:
+                return std::make_unique<DoubleBufferFileWriter>(bufferSize);
+            case FileBackend::IoUring:
+                #ifdef LOGGER_HAS_IO_URING
+                if (IoUringFileWriter::available()) {
+                    return std::make_unique<IoUringFileWriter>(bufferSize);
+                }
+                #endif
+                // io_uring 不可用：退回普通 write 路径
+                return std::make_unique<DoubleBufferFileWriter>(bufferSize);
+            case FileBackend::Mmap:
+                #ifdef LOGGER_HAS_MMAP
+                return std::make_unique<MmapFileWriter>(bufferSize);
+                #else
+                return std::make_unique<DoubleBufferFileWriter>(bufferSize);
+                #endif
+            case FileBackend::Direct:
+                #ifndef _WIN32
+                return std::make_unique<DirectFileWriter>(bufferSize);
+                #else
+                return std::make_unique<DoubleBufferFileWriter>(bufferSize);
+                #endif
+            default:
+                return std::make_unique<StdioFileWriter>();
+        }
+    }
+
+    /**
+     * @brief 按持久化级别提交文件中累积的数据（调用方需持有 mutex_）
+     * @param force true 时即使持久化级别为 None 也执行 fflush
+     */
+    void commitFile(bool force = false) {
+        if (!writer_ || pendingBytes_ == 0) return;
+        if (policy_.durability == FileDurability::None && !force) return;
+
+        writer_->commit(policy_.durability);
+        pendingBytes_ = 0;
+        lastCommit_ = std::chrono::steady_clock::now();
+    }
+
+    /**
+     * @brief 关闭日志文件，丢弃尚未用上的预备文件（调用方需持有 mutex_）
+     */
+    void closeFile() {
+        if (writer_) {
+            commitFile();
+            writer_->close();
+            droppedBytes_.fetch_add(writer_->droppedBytes(), std::memory_order_relaxed);
+            writer_.reset();
+        }
+
+        // 等待正在打开的预备文件，随后同步关闭并删除空的预备文件，
+        // 避免重新打开时与轮转线程的删除操作落在同一路径上
+        std::vector<Standby> discarded;
+        {
+            std::unique_lock<std::mutex> lock(rotatorMutex_);
+            rotatorCv_.wait(lock, [this] { return openingId_ == 0; });
+            for (Standby& slot : standby_) {
+                if (slot.writer) {
+                    discarded.push_back(std::move(slot));
+                }
+                slot = Standby{};
+            }
+        }
+        for (Standby& slot : discarded) {
+            slot.writer->close();
+            LogFileIO::removeIfEmpty(slot.path);
+        }
+    }
+
+    /**
+     * @brief 打开当前周期的日志文件（配置变更路径，调用方需持有 mutex_）
+     */
+    void openFile() {
+        closeFile(); // 先关闭已存在的文件
+        if (basePath_.empty()) return;
+
+        std::time_t start;
+        std::time_t end;
+        periodOf(std::time(nullptr), start, end);
+        openDirect(start, end, 0);
+        retention_.setPattern(stem() + "-");
+    }
+
+    /**
+     * @brief 在写入路径上同步打开文件，跳过已满的序号（调用方需持有 mutex_）
+     */
+    void openDirect(std::time_t start, std::time_t end, size_t index) {
+        std::string path = pathFor(start, index);
+        uint64_t bytes = LogFileIO::fileSize(path);
+        while (limit_.maxBytes != 0 && bytes >= limit_.maxBytes) {
+            path = pathFor(start, ++index);
+            bytes = LogFileIO::fileSize(path);
+        }
+
+        std::unique_ptr<LogFileWriter> writer = makeWriter(backend_, bufferSize_);
+        writer->setPreallocation(preallocate_);
+        if (writer->open(path, policy_)) {
+            install(std::move(writer), path, start, end, index, bytes);
+        }
+    }
+
+    /**
+     * @brief 切换到时刻 t 所在周期的首个文件（调用方需持有 mutex_）
+     */
+    void rotate(std::time_t t) {
+        std::time_t start;
+        std::time_t end;
+        periodOf(t, start, end);
+        switchTo(start, end, 0);
+    }
+
+    /**
+     * @brief 切换到指定周期与序号的文件（写入路径，调用方需持有 mutex_）
+     * @details 优先取用后台预先打开的文件；预备文件未就绪或不符（如长时间无日志）时才同步打开。
+     *          换下来的写入器交给轮转线程提交并关闭
+     */
+    void switchTo(std::time_t start, std::time_t end, size_t index) {
+        std::unique_ptr<LogFileWriter> next;
+        std::string path;
+        uint64_t bytes = 0;
+        {
+            std::unique_lock<std::mutex> lock(rotatorMutex_);
+            for (Standby& slot : standby_) {
+                if (slot.id == 0 || slot.period != start || slot.index != index) continue;
+                // 轮转线程正在打开该文件时等它完成，避免同一路径被打开两次
+                const uint64_t id = slot.id;
+                rotatorCv_.wait(lock, [this, id] { return openingId_ != id; });
+                if (slot.writer) {
+                    next = std::move(slot.writer);
+                    path = std::move(slot.path);
+                    bytes = slot.bytes;
+                }
+                // 未就绪的请求直接取消，改为同步打开
+                slot = Standby{};
+                break;
+            }
+            if (writer_) {
+                retired_.push_back(Retired{std::move(writer_), policy_.durability, std::string(), currentPath_});
+            }
+        }
+        rotatorCv_.notify_all();
+        pendingBytes_ = 0;
+
+        if (next) {
+            install(std::move(next), path, start, end, index, bytes);
+        } else {
+            openDirect(start, end, index);
+        }
+    }
+
+    /**
+     * @brief 启用新的写入器并请求预先打开后续文件（调用方需持有 mutex_）
+     */
+    void install(std::unique_ptr<LogFileWriter> writer, const std::string& path,
+                 std::time_t start, std::time_t end, size_t index, uint64_t bytes) {
+        writer_ = std::move(writer);
+        currentPath_ = path;
+        retention_.setActive(path);
+        periodStart_ = start;
+        nextRotation_ = end;
+        index_ = index;
+        fileBytes_ = bytes;
+        fileRecords_ = 0;
+        pendingBytes_ = 0;
+        lastCommit_ = std::chrono::steady_clock::now();
+
+        {
+            std::lock_guard<std::mutex> lock(rotatorMutex_);
+            prepare(standby_[NEXT_PERIOD], end, 0, end - static_cast<std::time_t>(standbyLead_.count()));
+            if (limit_.maxBytes != 0 || limit_.maxRecords != 0) {
+                prepare(standby_[NEXT_INDEX], start, index + 1, 0);
+            } else {
+                discardStandby(standby_[NEXT_INDEX]);
+                standby_[NEXT_INDEX] = Standby{};
+            }
+            if (!rotator_.joinable()) {
+                rotator_ = std::thread(&FileSink::rotatorLoop, this);
+            }
+        }
+        rotatorCv_.notify_all();
+    }
+
+    /**
+     * @brief 为预备槽位设置目标文件，已预先打开的同一文件保留（调用方需持有 rotatorMutex_）
+     */
+    void prepare(Standby& slot, std::time_t period, size_t index, std::time_t prepareAt) {
+        if (slot.id != 0 && slot.period == period && slot.index == index) return;
+        discardStandby(slot);
+        slot = Standby{};
+        slot.id = ++requestId_;
+        slot.period = period;
+        slot.index = index;
+        slot.prepareAt = prepareAt;
+        slot.path = pathFor(period, index);
+        slot.backend = backend_;
+        slot.bufferSize = bufferSize_;
+        slot.policy = policy_;
+        slot.preallocate = preallocate_;
+    }
+
+    /**
+     * @brief 把未用上的预备文件交给轮转线程关闭，若为空则删除（调用方需持有 rotatorMutex_）
+     */
+    void discardStandby(Standby& slot) {
+        if (slot.writer) {
+            retired_.push_back(Retired{std::move(slot.writer), FileDurability::None, slot.path, std::string()});
+            rotatorCv_.notify_all();
+        }
+    }
+
+    /**
+     * @brief 等待轮转线程关闭所有换下来的写入器（包括正在打开、可能被丢弃的预备文件）
+     */
+    void waitRetired() {
+        std::unique_lock<std::mutex> lock(rotatorMutex_);
+        rotatorCv_.wait(lock, [this] { return retired_.empty() && closing_ == 0 && openingId_ == 0; });
+    }
+
+    /**
+     * @brief 轮转线程：关闭换下来的写入器，到点后预先打开后续文件
+     */
+    void rotatorLoop() {
+        std::unique_lock<std::mutex> lock(rotatorMutex_);
+        for (;;) {
+            if (!retired_.empty()) {
+                std::vector<Retired> retired = std::move(retired_);
+                retired_.clear();
+                closing_ = retired.size();
+                lock.unlock();
+                for (Retired& r : retired) {
+                    if (r.durability != FileDurability::None) {
+                        r.writer->commit(r.durability);
+                    }
+                    r.writer->close();
+                    droppedBytes_.fetch_add(r.writer->droppedBytes(), std::memory_order_relaxed);
+                    if (!r.removeIfEmpty.empty()) {
+                        LogFileIO::removeIfEmpty(r.removeIfEmpty);
+                    }
+                    if (!r.rotated.empty() && !compressor_.submit(r.rotated)) {
+                        retention_.add(r.rotated);
+                    }
+                }
+                lock.lock();
+                closing_ = 0;
+                rotatorCv_.notify_all();
+                continue;
+            }
+            if (rotatorStop_) break;
+
+            // 找出已到打开时刻的预备槽位，其余槽位取最早的打开时刻
+            const auto now = std::chrono::system_clock::now();
+            Standby* due = nullptr;
+            auto wake = std::chrono::system_clock::time_point::max();
+            for (Standby& slot : standby_) {
+                if (slot.id == 0 || slot.writer || slot.failed) continue;
+                const auto prepareAt = std::chrono::system_clock::from_time_t(slot.prepareAt);
+                if (prepareAt <= now) {
+                    due = &slot;
+                    break;
+                }
+                wake = std::min(wake, prepareAt);
+            }
+
+            if (due) {
+                const uint64_t id = due->id;
+                const std::string path = due->path;
+                const FileBackend backend = due->backend;
+                const size_t bufferSize = due->bufferSize;
+                const FileCommitPolicy policy = due->policy;
+                const size_t preallocate = due->preallocate;
+                openingId_ = id;
+                lock.unlock();
+                const uint64_t bytes = LogFileIO::fileSize(path);
+                std::unique_ptr<LogFileWriter> writer = makeWriter(backend, bufferSize);
+                writer->setPreallocation(preallocate);
+                const bool opened = writer->open(path, policy);
+                lock.lock();
+                openingId_ = 0;
+                rotatorCv_.notify_all();
+
+                if (due->id != id) {
+                    // 等待期间请求已被替换或取消
+                    if (opened) {
+                        retired_.push_back(Retired{std::move(writer), FileDurability::None, path, std::string()});
+                    }
+                } else if (opened) {
+                    due->writer = std::move(writer);
+                    due->bytes = bytes;
+                } else {
+                    // 打不开就不再重试，切换时由写入方同步打开
+                    due->failed = true;
+                }
+                continue;
+            }
+            if (wake != std::chrono::system_clock::time_point::max()) {
+                rotatorCv_.wait_until(lock, wake);
+            } else {
+                rotatorCv_.wait(lock);
+            }
+        }
+    }
+
+    std::string basePath_;                  ///< 基础文件路径
+    FileBackend backend_;                   ///< 文件写出后端
+    size_t bufferSize_;                     ///< 文件后端缓冲区大小
+    size_t preallocate_;                    ///< 空间预分配步长（0 表示不预分配）
+    FileRotation rotation_;                 ///< 轮转周期
+    LogTimeZone zone_;                      ///< 轮转周期与文件名使用的时区
+    std::chrono::seconds standbyLead_;      ///< 提前打开下一个周期文件的时间
+    FileSizeLimit limit_;                   ///< 单个文件的大小上限
+    std::unique_ptr<LogFileWriter> writer_; ///< 当前文件写入器（未打开时为空）
+    std::string currentPath_;               ///< 当前文件路径
+    std::time_t periodStart_;               ///< 当前文件所属周期的起始时刻
+    std::time_t nextRotation_;              ///< 下一个轮转时刻（打开文件时算好）
+    size_t index_;                          ///< 当前文件在周期内的序号
+    uint64_t fileBytes_;                    ///< 当前文件的字节数
+    uint64_t fileRecords_;                  ///< 当前文件本次打开后写入的记录数
+    FileCommitPolicy policy_;               ///< 组提交策略
+    size_t pendingBytes_;                   ///< 上次提交后写入的字节数
+    std::chrono::steady_clock::time_point lastCommit_; ///< 上次提交时间
+
+    std::mutex rotatorMutex_;               ///< 保护以下轮转线程共享状态
+    std::condition_variable rotatorCv_;     ///< 唤醒轮转线程 / 通知关闭完成
+    std::thread rotator_;                   ///< 轮转线程（首次打开文件时启动）
+    Standby standby_[2];                    ///< 预备槽位（NEXT_PERIOD / NEXT_INDEX）
+    uint64_t requestId_;                    ///< 最近一次预备请求的编号
+    std::vector<Retired> retired_;          ///< 待关闭的写入器
+    size_t closing_;                        ///< 轮转线程正在关闭的写入器数
+    uint64_t openingId_;                    ///< 轮转线程正在打开的预备请求编号（0 表示无）
+    bool rotatorStop_;                      ///< 通知轮转线程退出
+    std::atomic<uint64_t> droppedBytes_;    ///< 已关闭写入器累计丢弃的字节数
+    LogRetention retention_;                ///< 已轮转文件的保留管理器（须晚于压缩器析构）
+    LogCompressor compressor_;              ///< 轮转下来的文件的后台压缩器
+};
+
+#ifdef LOGGER_HAS_ZLIB
+/**
+ * @brief 分帧压缩文件的帧索引项
+ */
+struct LogFrameInfo {
+    uint64_t offset;         ///< 帧在压缩文件中的偏移
+    uint64_t rawOffset;      ///< 帧内容在原始日志流中的偏移
+    std::time_t firstTime;   ///< 帧内第一条记录的时间（秒）
+    uint32_t size;           ///< 帧的压缩大小（含 gzip 头尾）
+    uint32_t rawSize;        ///< 帧的原始大小
+};
+
+/**
+ * @brief 分帧压缩日志的文件格式
+ * @details 数据文件由独立的 gzip 成员（帧）拼接而成，可直接用 zcat/gunzip 整体解压；
+ *          每帧的 gzip 头带 FEXTRA 子字段 'L','F' 记录本帧的压缩大小，
+ *          索引丢失时可沿帧头重建（与 BGZF 的做法相同）。
+ *          索引文件（数据文件名 + ".idx"）以 8 字节魔数开头，随后每帧一个 32 字节的小端记录：
+ *          offset(8) rawOffset(8) firstTime(8) size(4) rawSize(4)。
+ *          帧总在记录边界处结束，从任意帧开始解压得到的都是完整的日志行
+ */
+struct LogFrameFormat {
+    static constexpr char INDEX_MAGIC[8] = {'L', 'O', 'G', 'F', 'I', 'D', 'X', '1'}; ///< 索引文件魔数
+    static constexpr size_t HEADER_SIZE = 22;  ///< gzip 头：10 字节固定部分 + XLEN(2) + 子字段(4 + 6)
+    static constexpr size_t TRAILER_SIZE = 8;  ///< gzip 尾：CRC32 + ISIZE
+    static constexpr size_t ENTRY_SIZE = 32;   ///< 索引记录大小
+
+    static void putLe(unsigned char* p, uint64_t v, size_t bytes) {
+        for (size_t i = 0; i < bytes; ++i) p[i] = static_cast<unsigned char>(v >> (8 * i));
+    }
+
+    static uint64_t getLe(const unsigned char* p, size_t bytes) {
+        uint64_t v = 0;
+        for (size_t i = 0; i < bytes; ++i) v |= static_cast<uint64_t>(p[i]) << (8 * i);
+        return v;
+    }
+
+    /**
+     * @brief 编码一条索引记录
+     */
+    static void encodeEntry(const LogFrameInfo& frame, unsigned char* p) {
+        putLe(p, frame.offset, 8);
+        putLe(p + 8, frame.rawOffset, 8);
+        putLe(p + 16, static_cast<uint64_t>(static_cast<int64_t>(frame.firstTime)), 8);
+        putLe(p + 24, frame.size, 4);
+        putLe(p + 28, frame.rawSize, 4);
+    }
+
+    /**
+     * @brief 解码一条索引记录
+     */
+    static LogFrameInfo decodeEntry(const unsigned char* p) {
+        LogFrameInfo frame;
+        frame.offset = getLe(p, 8);
+        frame.rawOffset = getLe(p + 8, 8);
+        frame.firstTime = static_cast<std::time_t>(static_cast<int64_t>(getLe(p + 16, 8)));
+        frame.size = static_cast<uint32_t>(getLe(p + 24, 4));
+        frame.rawSize = static_cast<uint32_t>(getLe(p + 28, 4));
+        return frame;
+    }
+
+    /**
+     * @brief 写 gzip 头，FEXTRA 子字段 'L','F' 为 6 字节：帧的压缩大小（4 字节）+ 保留（2 字节）
+     * @details 原始大小取自 gzip 尾的 ISIZE
+     */
+    static void encodeHeader(unsigned char* p, uint32_t size) {
+        static constexpr unsigned char fixed[12] = {
+            0x1f, 0x8b, 8, 4 /* FEXTRA */, 0, 0, 0, 0, 0, 0xff, 10, 0 /* XLEN = 10 */};
+        std::memcpy(p, fixed, sizeof(fixed));
+        p[12] = 'L';
+        p[13] = 'F';
+        putLe(p + 14, 6, 2);
+        putLe(p + 16, size, 4);
+        putLe(p + 20, 0, 2);
+    }
+
+    /**
+     * @brief 从帧头读出压缩大小，不是本格式的帧时返回 0
+     */
+    static uint32_t decodeHeader(const unsigned char* p) {
+        if (p[0] != 0x1f || p[1] != 0x8b || p[2] != 8 || p[3] != 4) return 0;
+        if (getLe(p + 10, 2) != 10 || p[12] != 'L' || p[13] != 'F' || getLe(p + 14, 2) != 6) return 0;
+        return static_cast<uint32_t>(getLe(p + 16, 4));
+    }
+};
+
+/**
+ * @brief 分帧压缩日志的读取器
+ * @details 读取帧索引（索引缺失或与数据文件不符时沿帧头重建），
+ *          可按原始偏移或时间定位到某一帧并只解压该帧
+ */
+class FramedLogReader {
+public:
+    /**
+     * @brief 打开分帧压缩日志并加载帧索引
+     * @return 是否打开成功
+     */
+    bool open(const std::string& path) {
+        frames_.clear();
+        data_.close();
+        data_.clear();
+        data_.open(path, std::ios::binary);
+        if (!data_) return false;
+        data_.seekg(0, std::ios::end);
+        const uint64_t fileSize = static_cast<uint64_t>(data_.tellg());
+        if (!loadIndex(path + ".idx", fileSize)) {
+            rebuildIndex(fileSize);
+        }
+        return true;
+    }
+
+    /**
+     * @brief 帧数
+     */
+    size_t frameCount() const { return frames_.size(); }
+
+    /**
+     * @brief 第 i 帧的索引项
+     */
+    const LogFrameInfo& frame(size_t i) const { return frames_[i]; }
+
+    /**
+     * @brief 原始日志流的总大小
+     */
+    uint64_t rawSize() const {
+        return frames_.empty() ? 0 : frames_.back().rawOffset + frames_.back().rawSize;
+    }
+
+    /**
+     * @brief 包含原始偏移 rawOffset 的帧
+     * @return 帧序号，超出范围时返回 frameCount()
+     */
+    size_t findOffset(uint64_t rawOffset) const {
+        auto it = std::upper_bound(frames_.begin(), frames_.end(), rawOffset,
+            [](uint64_t value, const LogFrameInfo& f) { return value < f.rawOffset; });
+        if (it == frames_.begin() || rawOffset >= rawSize()) return frames_.size();
+        return static_cast<size_t>(it - frames_.begin()) - 1;
+    }
+
+    /**
+     * @brief 可能包含时间 t 及之后记录的第一帧（首条记录时间不晚于 t 的最后一帧）
+     */
+    size_t findTime(std::time_t t) const {
+        auto it = std::upper_bound(frames_.begin(), frames_.end(), t,
+            [](std::time_t value, const LogFrameInfo& f) { return value < f.firstTime; });
+        return it == frames_.begin() ? 0 : static_cast<size_t>(it - frames_.begin()) - 1;
+    }
+
+    /**
+     * @brief 只解压第 i 帧
+     * @param out 追加解压后的日志行
+     * @return 是否解压成功
+     */
+    bool readFrame(size_t i, std::string& out) {
+        if (i >= frames_.size()) return false;
+        const LogFrameInfo& f = frames_[i];
+        std::string packed(f.size, '\0');
+        data_.clear();
+        data_.seekg(static_cast<std::streamoff>(f.offset));
+        if (!data_.read(packed.data(), static_cast<std::streamsize>(packed.size()))) return false;
+
+        z_stream zs;
+        std::memset(&zs, 0, sizeof(zs));
+        if (inflateInit2(&zs, 16 + 15) != Z_OK) return false;
+        const size_t base = out.size();
+        out.resize(base + f.rawSize);
+        zs.next_in = reinterpret_cast<Bytef*>(packed.data());
+        zs.avail_in = static_cast<uInt>(packed.size());
+        zs.next_out = reinterpret_cast<Bytef*>(out.data() + base);
+        zs.avail_out = f.rawSize;
+        const int rc = inflate(&zs, Z_FINISH);
+        const bool ok = rc == Z_STREAM_END && zs.total_out == f.rawSize;
+        inflateEnd(&zs);
+        if (!ok) out.resize(base);
+        return ok;
+    }
+
+private:
+    /**
+     * @brief 读取索引文件，覆盖完整数据文件时返回 true
+     */
+    bool loadIndex(const std::string& indexPath, uint64_t fileSize) {
+        std::ifstream index(indexPath, std::ios::binary);
+        char magic[sizeof(LogFrameFormat::INDEX_MAGIC)];
+        if (!index.read(magic, sizeof(magic)) ||
+            std::memcmp(magic, LogFrameFormat::INDEX_MAGIC, sizeof(magic)) != 0) {
+            return false;
+        }
+        unsigned char entry[LogFrameFormat::ENTRY_SIZE];
+        uint64_t end = 0;
+        while (index.read(reinterpret_cast<char*>(entry), sizeof(entry))) {
+            LogFrameInfo f = LogFrameFormat::decodeEntry(entry);
+            if (f.offset != end) break;
+            frames_.push_back(f);
+            end = f.offset + f.size;
+        }
+        if (end != fileSize) {
+            frames_.clear();
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief 沿帧头重建索引（firstTime 取帧内第一行的时间戳）
+     */
+    void rebuildIndex(uint64_t fileSize) {
+        frames_.clear();
+        uint64_t offset = 0;
+        uint64_t rawOffset = 0;
+        unsigned char header[LogFrameFormat::HEADER_SIZE];
+        while (offset + LogFrameFormat::HEADER_SIZE + LogFrameFormat::TRAILER_SIZE <= fileSize) {
+            data_.clear();
+            data_.seekg(static_cast<std::streamoff>(offset));
+            if (!data_.read(reinterpret_cast<char*>(header), sizeof(header))) break;
+            const uint32_t size = LogFrameFormat::decodeHeader(header);
+            if (size < LogFrameFormat::HEADER_SIZE + LogFrameFormat::TRAILER_SIZE ||
+                offset + size > fileSize) {
+                break; // 截断的末帧（写入中途崩溃）不纳入索引
+            }
+            unsigned char trailer[LogFrameFormat::TRAILER_SIZE];
+            data_.seekg(static_cast<std::streamoff>(offset + size - sizeof(trailer)));
+            if (!data_.read(reinterpret_cast<char*>(trailer), sizeof(trailer))) break;
+
+            LogFrameInfo f{offset, rawOffset, 0, size,
+                           static_cast<uint32_t>(LogFrameFormat::getLe(trailer + 4, 4))};
+            frames_.push_back(f);
+            std::string text;
+            if (readFrame(frames_.size() - 1, text)) {
+                frames_.back().firstTime = parseTime(text);
+            }
+            offset += size;
+            rawOffset += f.rawSize;
+        }
+    }
+
+    /**
+     * @brief 解析行首的 "YYYY-MM-DD HH:MM:SS" 时间（小数部分后带 Z 时按 UTC，否则按本地时间）
+     */
+    static std::time_t parseTime(const std::string& line) {
+        std::tm tm{};
+        if (line.size() < 19 ||
+            std::sscanf(line.c_str(), "%4d-%2d-%2d %2d:%2d:%2d", &tm.tm_year, &tm.tm_mon, &tm.tm_mday,
+                        &tm.tm_hour, &tm.tm_min, &tm.tm_sec) != 6) {
+            return 0;
+        }
+        size_t pos = 19;
+        if (pos < line.size() && line[pos] == '.') {
+            while (++pos < line.size() && std::isdigit(static_cast<unsigned char>(line[pos]))) {}
+        }
+        if (pos < line.size() && line[pos] == 'Z') {
+            LogTimeZone utc(TimeZoneMode::Utc);
+            return utc.fromCivil(tm.tm_year, static_cast<unsigned>(tm.tm_mon), static_cast<unsigned>(tm.tm_mday),
+                                 static_cast<unsigned>(tm.tm_hour), static_cast<unsigned>(tm.tm_min),
+                                 static_cast<unsigned>(tm.tm_sec));
+        }
+        tm.tm_year -= 1900;
+        tm.tm_mon -= 1;
+        tm.tm_isdst = -1;
+        return std::mktime(&tm);
+    }
+
+    std::ifstream data_;               ///< 数据文件
+    std::vector<LogFrameInfo> frames_; ///< 帧索引
+};
+
+/**
+ * @brief 分帧压缩文件的参数
+ */
+struct FramedFileOptions {
+    size_t frameSize = 1 << 20;                      ///< 每帧的原始数据量，累积到该大小时压缩写出
+    int level = 6;                                   ///< 压缩级别（1-9）
+    std::chrono::milliseconds maxFrameAge{1000};     ///< 帧内最早数据的最长等待时间，0 表示只按大小切帧
+};
+
+/**
+ * @brief 分帧压缩文件输出（需要 zlib）
+ * @details 渲染好的日志行先累积在帧缓冲区，达到 frameSize、超过 maxFrameAge
+ *          或 drain() 时整帧压缩为一个独立的 gzip 成员写出，随后追加一条帧索引；
+ *          数据先于索引落盘，索引永远不会指向不存在的数据。
+ *          压缩在写出路径（异步模式下为后台线程）中进行，不需要额外线程；
+ *          用 FramedLogReader 可按偏移或时间定位并只解压一帧。
+ *          作为附加 sink 使用，例如把 DEBUG 级别的全量日志压缩保存：
+ *          @code
+ *          auto debug = std::make_shared<FramedFileSink>();
+ *          debug->open("debug.log.gz");
+ *          Logger::getInstance().addSink(debug);
+ *          @endcode
+ */
+class FramedFileSink : public LogSink {
+public:
+    FramedFileSink() : data_(nullptr), index_(nullptr), offset_(0), rawOffset_(0), firstTime_(0) {
+        std::memset(&zs_, 0, sizeof(zs_));
+        deflateInit2(&zs_, options_.level, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY);
+    }
+
+    ~FramedFileSink() override {
+        close();
+        deflateEnd(&zs_);
+    }
+
+    /**
+     * @brief 打开（或续写）分帧压缩文件，同时打开 path + ".idx" 索引文件
+     * @details 续写已有文件时先校验或重建其索引，丢弃写入中途崩溃留下的残缺末帧。
+     *          已有的非空文件不以帧头开始（不是分帧压缩文件）时返回 false，文件与索引保持原样
+     * @return 是否打开成功
+     */
+    bool open(const std::string& path) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        closeFile();
+
+        // 已有数据：取得完整帧的索引，截掉残缺的末帧后重写索引文件
+        FramedLogReader existing;
+        std::vector<LogFrameInfo> frames;
+        if (existing.open(path)) {
+            for (size_t i = 0; i < existing.frameCount(); ++i) frames.push_back(existing.frame(i));
+        }
+        std::error_code ec;
+        const uint64_t fileSize = std::filesystem::file_size(path, ec);
+        if (!ec && fileSize != 0 && frames.empty() && !startsWithFrame(path)) return false;
+        offset_ = frames.empty() ? 0 : frames.back().offset + frames.back().size;
+        rawOffset_ = existing.rawSize();
+        if (!ec && fileSize != offset_) {
+            std::filesystem::resize_file(path, offset_, ec);
+        }
+
+        data_ = std::fopen(path.c_str(), "ab");
+        index_ = std::fopen((path + ".idx").c_str(), "wb");
+        if (!data_ || !index_) {
+            closeFile();
+            return false;
+        }
+        std::fwrite(LogFrameFormat::INDEX_MAGIC, 1, sizeof(LogFrameFormat::INDEX_MAGIC), index_);
+        for (const LogFrameInfo& f : frames) {
+            writeEntry(f);
+        }
+        std::fflush(index_);
+        return true;
+    }
+
+    /**
+     * @brief 写出未满的帧并关闭文件
+     */
+    void close() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        flushFrame();
+        closeFile();
+    }
+
+    /**
+     * @brief 文件是否已打开
+     */
+    bool isOpen() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return data_ != nullptr;
+    }
+
+    /**
+     * @brief 设置分帧参数（对下一帧生效）
+     */
+    void setOptions(const FramedFileOptions& options) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        options_ = options;
+        deflateParams(&zs_, options_.level, Z_DEFAULT_STRATEGY);
+    }
+
+    /**
+     * @brief 获取分帧参数
+     */
+    FramedFileOptions getOptions() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return options_;
+    }
+
+protected:
+    void write(std::span<const LogLine> lines) override {
+        if (!data_) return;
+        for (const LogLine& line : lines) {
+            if (frame_.empty()) {
+                firstTime_ = line.time;
+                frameStart_ = std::chrono::steady_clock::now();
+            }
+            frame_.append(line.text.data(), line.text.size());
+            // 只在记录边界切帧
+            if (frame_.size() >= options_.frameSize) {
+                flushFrame();
+            }
+        }
+        commitIfDue();
+    }
+
+    void commit() override {
+        flushFrame();
+    }
+
+    void commitIfDue() override {
+        if (frame_.empty() || options_.maxFrameAge.count() == 0) return;
+        if (std::chrono::steady_clock::now() - frameStart_ >= options_.maxFrameAge) {
+            flushFrame();
+        }
+    }
+
+private:
+    /**
+     * @brief 已有文件是否以帧头开始（不足一个帧头时只要求 gzip 魔数），即写入首帧时中断的分帧文件
+     */
+    static bool startsWithFrame(const std::string& path) {
+        std::ifstream in(path, std::ios::binary);
+        unsigned char header[LogFrameFormat::HEADER_SIZE];
+        in.read(reinterpret_cast<char*>(header), sizeof(header));
+        const std::streamsize n = in.gcount();
+        if (n == static_cast<std::streamsize>(sizeof(header))) {
+            return LogFrameFormat::decodeHeader(header) != 0;
+        }
+        return n >= 2 && header[0] == 0x1f && header[1] == 0x8b;
+    }
+
+    /**
+     * @brief 把帧缓冲区压缩为一个 gzip 成员写出，并追加索引（调用方需持有 mutex_）
+     */
+    void flushFrame() {
+        if (!data_ || frame_.empty()) return;
+
+        deflateReset(&zs_);
+        packed_.resize(LogFrameFormat::HEADER_SIZE + deflateBound(&zs_, static_cast<uLong>(frame_.size())) +
+                       LogFrameFormat::TRAILER_SIZE);
+        unsigned char* out = reinterpret_cast<unsigned char*>(packed_.data());
+        zs_.next_in = reinterpret_cast<Bytef*>(frame_.data());
+        zs_.avail_in = static_cast<uInt>(frame_.size());
+        zs_.next_out = out + LogFrameFormat::HEADER_SIZE;
+        zs_.avail_out = static_cast<uInt>(packed_.size() - LogFrameFormat::HEADER_SIZE - LogFrameFormat::TRAILER_SIZE);
+        if (deflate(&zs_, Z_FINISH) != Z_STREAM_END) {
+            frame_.clear();
+            return;
+        }
+
+        const size_t size = LogFrameFormat::HEADER_SIZE + zs_.total_out + LogFrameFormat::TRAILER_SIZE;
+        const uLong crc = crc32(crc32(0, nullptr, 0), reinterpret_cast<const Bytef*>(frame_.data()),
+                                static_cast<uInt>(frame_.size()));
+        LogFrameFormat::encodeHeader(out, static_cast<uint32_t>(size));
+        unsigned char* trailer = out + size - LogFrameFormat::TRAILER_SIZE;
+        LogFrameFormat::putLe(trailer, crc, 4);
+        LogFrameFormat::putLe(trailer + 4, frame_.size(), 4);
+
+        // 先写数据再写索引：索引只引用已经写出的帧
+        if (std::fwrite(out, 1, size, data_) == size && std::fflush(data_) == 0) {
+            writeEntry(LogFrameInfo{offset_, rawOffset_, firstTime_, static_cast<uint32_t>(size),
+                                    static_cast<uint32_t>(frame_.size())});
+            std::fflush(index_);
+            offset_ += size;
+            rawOffset_ += frame_.size();
+        }
+        frame_.clear();
+    }
+
+    /**
+     * @brief 追加一条索引记录
+     */
+    void writeEntry(const LogFrameInfo& frame) {
+        unsigned char entry[LogFrameFormat::ENTRY_SIZE];
+        LogFrameFormat::encodeEntry(frame, entry);
+        std::fwrite(entry, 1, sizeof(entry), index_);
+    }
+
+    /**
+     * @brief 关闭数据与索引文件（调用方需持有 mutex_）
+     */
+    void closeFile() {
+        if (data_) std::fclose(data_);
+        if (index_) std::fclose(index_);
+        data_ = nullptr;
+        index_ = nullptr;
+        frame_.clear();
+    }
+
+    FramedFileOptions options_;   ///< 分帧参数
+    z_stream zs_;                 ///< 复用的 raw deflate 压缩流
+    FILE* data_;                  ///< 数据文件
+    FILE* index_;                 ///< 索引文件
+    uint64_t offset_;             ///< 下一帧在数据文件中的偏移
+    uint64_t rawOffset_;          ///< 下一帧在原始日志流中的偏移
+    std::string frame_;           ///< 当前帧的原始数据
+    std::string packed_;          ///< 压缩输出缓冲区
+    std::time_t firstTime_;       ///< 当前帧第一条记录的时间
+    std::chrono::steady_clock::time_point frameStart_; ///< 当前帧开始累积的时间
+};
+#endif
+
+/**
+ * @brief 有界队列写满时的处理策略
+ */
+enum class OverflowPolicy {
+    Block,          ///< 阻塞等待后台线程腾出空间
+    DropNewest,     ///< 丢弃当前提交的记录
+    DropOldest,     ///< 丢弃队列中最旧的记录，为新记录腾出空间
+    DropBelowLevel  ///< 低于指定级别的记录直接丢弃，其余阻塞等待
+};
+
+/**
+ * @brief 有界多生产者队列（基于序号的无锁数组队列）
+ * @details 槽位数量与单条消息大小在构造时固定，内存占用有硬上限；
+ *          支持多生产者并发入队，出队同样无锁，
+ *          因此 DropOldest 策略下生产者也可以弹出最旧的记录
+ */
+class LogBoundedQueue {
+public:
+    static constexpr size_t SLOT_MESSAGE_SIZE = 4096; ///< 单条消息的最大字节数
+
+    /**
+     * @brief 构造函数
+     * @param capacity 槽位数量，向上取整为 2 的幂
+     */
+    explicit LogBoundedQueue(size_t capacity)
+        : mask_(roundUpPow2(capacity) - 1), slots_(new Slot[mask_ + 1]),
+          enqueuePos_(0), dequeuePos_(0) {
+        for (size_t i = 0; i <= mask_; ++i) {
+            slots_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    LogBoundedQueue(const LogBoundedQueue&) = delete;
+    LogBoundedQueue& operator=(const LogBoundedQueue&) = delete;
+
+    /**
+     * @brief 槽位数量
+     */
+    size_t capacity() const { return mask_ + 1; }
+
+    /**
+     * @brief 尝试入队
+     * @param record 日志记录，消息长度不得超过 SLOT_MESSAGE_SIZE
+     * @return 队列已满时返回 false
+     */
+    bool tryPush(const LogRecord& record) {
+        size_t pos = enqueuePos_.load(std::memory_order_relaxed);
+        Slot* slot;
+        for (;;) {
+            slot = &slots_[pos & mask_];
+            const size_t seq = slot->sequence.load(std::memory_order_acquire);
+            const intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (enqueuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = enqueuePos_.load(std::memory_order_relaxed);
+            }
+        }
+
+        slot->record = record;
+        std::memcpy(slot->message, record.message, record.length);
+        slot->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief 尝试出队一条记录
+     * @param fn 回调，参数为 const LogRecord&，在槽位释放前调用
+     * @return 队列为空时返回 false
+     */
+    template <typename Fn>
+    bool tryPop(Fn&& fn) {
+        size_t pos = dequeuePos_.load(std::memory_order_relaxed);
+        Slot* slot;
+        for (;;) {
+            slot = &slots_[pos & mask_];
+            const size_t seq = slot->sequence.load(std::memory_order_acquire);
+            const intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+            if (diff == 0) {
+                if (dequeuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = dequeuePos_.load(std::memory_order_relaxed);
+            }
+        }
+
+        slot->record.message = slot->message;
+        fn(slot->record);
+        slot->sequence.store(pos + mask_ + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    /**
+     * @brief 队列槽位
+     */
+    struct Slot {
+        std::atomic<size_t> sequence;  ///< 槽位序号，标识可写/可读状态
+        LogRecord record;              ///< 记录头
+        char message[SLOT_MESSAGE_SIZE];
+    };
+
+    static size_t roundUpPow2(size_t n) {
+        size_t cap = 2;
+        while (cap < n) cap <<= 1;
+        return cap;
+    }
+
+    const size_t mask_;                          ///< 下标掩码
+    std::unique_ptr<Slot[]> slots_;              ///< 槽位数组
+    alignas(64) std::atomic<size_t> enqueuePos_; ///< 入队位置
+    alignas(64) std::atomic<size_t> dequeuePos_; ///< 出队位置
+};
+
+/**
+ * @brief Logger 日志类（单例模式）
+ * @details 线程安全的日志记录器，支持：
+ *          - 控制台彩色输出
+ *          - 文件日志记录（按日期自动轮转）
+ *          - 日志级别过滤
+ *          - 使用 std::atomic 和 std::mutex 保证线程安全
+ */
+class Logger {
+public:
+    /**
+     * @brief 获取 Logger 单例实例
+     * @return Logger 实例的引用
+     */
+    static Logger& getInstance() {
+        static Logger instance;
+        return instance;
+    }
+
+    /**
+     * @brief 设置日志级别
+     * @param level 日志级别，低于此级别的日志将被过滤
+     */
+    void setLevel(LogLevel level) {
+        level_.store(level);
+    }
+
+    /**
+     * @brief 获取当前日志级别
+     * @return 当前日志级别
+     */
+    LogLevel getLevel() const {
+        return level_.load();
+    }
+
+    /**
+     * @brief 该级别的日志是否会被记录
+     * @details 只有一次 relaxed 原子读取，不经过 getInstance() 的初始化检查；
+     *          LOG_* 宏据此在求值任何参数之前跳过被过滤的调用。
+     *          低于 LOGGER_ACTIVE_LEVEL 的级别在编译期即为 false
+     */
+    static bool isEnabled(LogLevel level) noexcept {
+        return logLevelCompiled(level) && level >= level_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief 该级别的记录是否会被某个输出目标写出
+     * @details 在 isEnabled() 之外还检查当前各输出目标的级别；
+     *          调用点据此决定是否采样时间戳与全局序号，被过滤的记录不占用序号
+     */
+    bool willRecord(LogLevel level) {
+        return isEnabled(level) && anyAccepts(currentSinks(), level);
+    }
+
+    /**
+     * @brief 设置时间戳精度
+     * @param precision 秒 / 毫秒 / 微秒 / 纳秒，默认秒
+     */
+    void setTimePrecision(TimePrecision precision) {
+        timePrecision_.store(precision, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief 获取时间戳精度
+     */
+    TimePrecision getTimePrecision() const {
+        return timePrecision_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief 设置时间戳与文件轮转使用的时区
+     * @param mode Local：本地时间（默认）；
+     *             CachedLocal：本地时间，缓存 UTC 偏移，不再每次调用 localtime_r；
+     *             Utc：UTC 时间，时间戳以 Z 结尾，文件在 UTC 零点轮转
+     */
+    void setTimeZone(TimeZoneMode mode) {
+        timeZone_.store(mode, std::memory_order_relaxed);
+        fileSink_->setTimeZone(mode);
+    }
+
+    /**
+     * @brief 获取时间戳使用的时区
+     */
+    TimeZoneMode getTimeZone() const {
+        return timeZone_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief 设置调用点时间来源
+     * @param source Realtime：调用点读取墙上时钟；
+     *               Tsc：调用点只读取周期计数器（几纳秒），写出时换算为墙上时间
+     * @details 切换到 Tsc 时同步校准约 10ms
+     */
+    void setClockSource(ClockSource source) {
+        if (source == ClockSource::Tsc) {
+            tickClock_.calibrate();
+        }
+        clockSource_.store(source, std::memory_order_release);
+    }
+
+    /**
+     * @brief 获取调用点时间来源
+     */
+    ClockSource getClockSource() const {
+        return clockSource_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief 按当前时间来源在调用点采样时间
+     */
+    LogTimestamp now() const {
+        if (clockSource_.load(std::memory_order_relaxed) == ClockSource::Tsc) {
+            return LogTimestamp{0, 0, LogTickClock::ticks()};
+        }
+        return LogClock::now();
+    }
+
+    /**
+     * @brief 启用或关闭全局序号
+     * @param enable true 时每条记录在调用点取一个全局递增序号，
+     *               输出为时间戳后的 "#N"，可据此检查跨线程顺序与丢失
+     */
+    void setSequenceNumbers(bool enable) {
+        sequenceEnabled_.store(enable, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief 是否启用全局序号
+     */
+    bool isSequenceNumbers() const {
+        return sequenceEnabled_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief 在调用点取下一个全局序号（未启用时返回 0）
+     */
+    uint64_t nextSequence() {
+        if (!sequenceEnabled_.load(std::memory_order_relaxed)) return 0;
+        return sequence_.fetch_add(1, std::memory_order_relaxed) + 1;
+    }
+
+    /**
+     * @brief 设置是否输出到控制台
+     * @param console true 启用控制台输出，false 禁用
+     */
+    void setConsole(bool console) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        consoleEnabled_ = console;
+        publishSinks();
+    }
+
+    /**
+     * @brief 设置文件日志输出
+     * @param enable true 启用文件输出，false 禁用
+     * @param filePath 日志文件路径，文件名会自动添加日期后缀（如：-20260218.log）
+     */
+    void setFile(bool enable, const std::string& filePath) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        fileEnabled_ = enable;
+
+        if (enable && !filePath.empty()) {
+            fileSink_->open(filePath);
+        } else {
+            fileSink_->close();
+        }
+        publishSinks();
+    }
+
+    /**
+     * @brief 设置文件组提交策略
+     * @param policy 提交策略
+     * @details 已打开的文件会先提交残留数据，再按新的缓冲区大小重新打开
+     */
+    void setFileCommitPolicy(const FileCommitPolicy& policy) {
+        fileSink_->setCommitPolicy(policy);
+    }
+
+    /**
+     * @brief 设置文件写出后端
+     * @param backend 后端类型
+     * @param bufferSize 后端缓冲区大小（DoubleBuffered 为单个缓冲区大小）
+     * @details 已打开的文件会按新后端重新打开，路径与日期后缀规则不变
+     */
+    void setFileBackend(FileBackend backend, size_t bufferSize = DEFAULT_FILE_BUFFER_SIZE) {
+        fileSink_->setBackend(backend, bufferSize);
+    }
+
+    /**
+     * @brief 获取当前文件写出后端
+     */
+    FileBackend getFileBackend() {
+        return fileSink_->getBackend();
+    }
+
+    /**
+     * @brief 获取日志文件因写出后端失败而累计丢弃的字节数
+     * @details 与 droppedCount() 统计的有界队列丢弃相互独立
+     */
+    uint64_t fileDroppedBytes() {
+        return fileSink_->droppedBytes();
+    }
+
+    /**
+     * @brief 获取当前文件组提交策略
+     */
+    FileCommitPolicy getFileCommitPolicy() {
+        return fileSink_->getCommitPolicy();
+    }
+
+    /**
+     * @brief 设置日志文件的空间预分配步长
+     * @param chunk 每次在文件末尾之后预留的字节数（如 64 MiB），0 表示不预分配（默认）
+     * @details Linux 上以 fallocate(FALLOC_FL_KEEP_SIZE) 预留，文件大小不变，关闭时释放未用完的尾部；
+     *          Mmap 后端本身按段预分配，Direct 后端不预分配
+     */
+    void setFilePreallocation(size_t chunk) {
+        fileSink_->setPreallocation(chunk);
+    }
+
+    /**
+     * @brief 获取日志文件的空间预分配步长
+     */
+    size_t getFilePreallocation() {
+        return fileSink_->getPreallocation();
+    }
+
+    /**
+     * @brief 设置文件轮转周期
+     * @param rotation 按天（本地零点）或按小时（整点）
+     * @param standbyLead 后台提前打开下一个文件的时间
+     */
+    void setFileRotation(FileRotation rotation,
+                         std::chrono::seconds standbyLead = FileSink::DEFAULT_STANDBY_LEAD) {
+        fileSink_->setRotation(rotation, standbyLead);
+    }
+
+    /**
+     * @brief 获取文件轮转周期
+     */
+    FileRotation getFileRotation() {
+        return fileSink_->getRotation();
+    }
+
+    /**
+     * @brief 设置单个日志文件的大小上限，超过后切换到同一周期的下一个序号
+     */
+    void setFileSizeLimit(const FileSizeLimit& limit) {
+        fileSink_->setSizeLimit(limit);
+    }
+
+    /**
+     * @brief 获取单个日志文件的大小上限
+     */
+    FileSizeLimit getFileSizeLimit() {
+        return fileSink_->getSizeLimit();
+    }
+
+    /**
+     * @brief 设置轮转下来的日志文件的后台压缩（gzip，按块并行）
+     * @details 需要以 LOGGER_WITH_ZLIB 编译并链接 zlib，否则文件保持原样
+     */
+    void setFileCompression(const FileCompression& compression) {
+        fileSink_->setCompression(compression);
+    }
+
+    /**
+     * @brief 获取后台压缩配置
+     */
+    FileCompression getFileCompression() {
+        return fileSink_->getCompression();
+    }
+
+    /**
+     * @brief 等待已轮转的日志文件压缩完成
+     */
+    void waitFileCompression() {
+        fileSink_->waitCompressed();
+    }
+
+    /**
+     * @brief 设置已轮转日志文件的保留策略（文件数、保留时间、总大小）
+     * @details 在后台线程中删除超出预算的最旧文件，打开日志文件时也会清理历史遗留的文件
+     */
+    void setFileRetention(const FileRetention& retention) {
+        fileSink_->setRetention(retention);
+    }
+
+    /**
+     * @brief 获取已轮转日志文件的保留策略
+     */
+    FileRetention getFileRetention() {
+        return fileSink_->getRetention();
+    }
+
+    /**
+     * @brief 等待已轮转的日志文件按保留策略处理完成
+     */
+    void waitFileRetention() {
+        fileSink_->waitRetained();
+    }
+
+    /**
+     * @brief 注册附加输出目标
+     * @param sink 输出目标，只接收不低于其 getLevel() 的日志行
+     * @details 与内置的控制台/文件输出并列，每个 sink 在自己的锁内批量写出；
+     *          异步模式下由后台线程按批投递
+     */
+    void addSink(std::shared_ptr<LogSink> sink) {
+        if (!sink) return;
+        std::lock_guard<std::mutex> lock(mutex_);
+        sinks_.push_back(std::move(sink));
+        publishSinks();
+    }
+
+    /**
+     * @brief 移除附加输出目标
+     * @details 返回时其他线程可能仍在完成对该 sink 的最后一次写出，
+     *          sink 对象由 shared_ptr 保持存活
+     */
+    void removeSink(const std::shared_ptr<LogSink>& sink) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::erase(sinks_, sink);
+        publishSinks();
+    }
+
+    /**
+     * @brief 启用或关闭异步日志模式
+     * @param enable true 启用异步模式，false 恢复同步写出
+     * @param ringCapacity 每个生产线程环形缓冲区的字节数
+     * @details 异步模式下，调用线程只把记录拷贝进本线程独占的无锁环形缓冲区，
+     *          由后台线程统一排空并执行控制台/文件输出。
+     *          关闭时会等待后台线程写完所有已提交的记录。
+     *          切换模式应在没有并发日志调用时进行
+     */
+    void setAsync(bool enable, size_t ringCapacity = DEFAULT_RING_CAPACITY) {
+        std::lock_guard<std::mutex> lock(asyncMutex_);
+        ringCapacity_.store(ringCapacity);
+        switchMode(enable ? AsyncMode::ThreadRings : AsyncMode::Off);
+    }
+
+    /**
+     * @brief 启用或关闭有界队列异步模式
+     * @param enable true 启用，false 恢复同步写出
+     * @param capacity 队列槽位数量（每个槽位约 4 KiB）
+     * @param policy 队列写满时的处理策略
+     * @param dropBelow DropBelowLevel 策略下的级别阈值，低于此级别的记录在队列满时被丢弃
+     * @details 与 setAsync 互斥：所有线程共享一个固定容量的队列，
+     *          内存占用和（非 Block 策略下的）生产者延迟都有硬上限。
+     *          被丢弃的记录按级别计数，后台线程定期输出 "N records dropped" 汇总
+     */
+    void setBoundedQueue(bool enable, size_t capacity = DEFAULT_QUEUE_CAPACITY,
+                         OverflowPolicy policy = OverflowPolicy::Block,
+                         LogLevel dropBelow = LogLevel::WARNING) {
+        std::lock_guard<std::mutex> lock(asyncMutex_);
+        if (!enable) {
+            switchMode(AsyncMode::Off);
+            return;
+        }
+
+        // 先停止后台线程，保证旧队列已排空
+        switchMode(AsyncMode::Off);
+        overflowPolicy_.store(policy);
+        dropBelow_.store(dropBelow);
+        if (!queue_.load() || queue_.load()->capacity() < capacity ||
+            queue_.load()->capacity() >= capacity * 2) {
+            // 旧队列保留到析构，避免与仍持有指针的生产者竞争
+            queues_.push_back(std::make_unique<LogBoundedQueue>(capacity));
+            queue_.store(queues_.back().get());
+        }
+        switchMode(AsyncMode::BoundedQueue);
+    }
+
+    /**
+     * @brief 启用或关闭延迟格式化
+     * @param enable true 启用，false 关闭
+     * @details 启用后 LogStream（及 log_info 等函数）只在调用线程记录参数的原始字节，
+     *          数值/指针到文本的转换推迟到写出时完成；
+     *          与 setAsync/setBoundedQueue 配合使用时，格式化开销完全转移到后台线程
+     */
+    void setDeferredFormat(bool enable) {
+        deferred_.store(enable, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief 是否启用延迟格式化
+     */
+    bool isDeferredFormat() const {
+        return deferred_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief 是否处于异步模式（环形缓冲区或有界队列）
+     */
+    bool isAsync() const {
+        return mode_.load(std::memory_order_acquire) != AsyncMode::Off;
+    }
+
+    /**
+     * @brief 获取某一级别累计被丢弃的记录数
+     * @param level 日志级别
+     */
+    uint64_t droppedCount(LogLevel level) const {
+        return dropped_[level].load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief 获取累计被丢弃的记录总数
+     */
+    uint64_t droppedCount() const {
+        uint64_t total = 0;
+        for (const auto& counter : dropped_) {
+            total += counter.load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+
+    /**
+     * @brief 等待所有已提交的日志写出
+     * @details 异步模式下阻塞直到后台线程处理完调用前提交的全部记录；
+     *          随后（同步模式下直接）按组提交策略提交文件中尚未提交的数据
+     */
+    void drain() {
+        std::lock_guard<std::mutex> asyncLock(asyncMutex_);
+        if (!isAsync()) {
+            flushSinks();
+            return;
+        }
+
+        std::unique_lock<std::mutex> lock(drainMutex_);
+        const uint64_t ticket = drainRequested_.fetch_add(1) + 1;
+        wakeBackend(true);
+        drainCv_.wait(lock, [&] { return drainCompleted_.load() >= ticket; });
+    }
+
+    /**
+     * @brief 核心日志记录函数
+     * @param level 日志级别
+     * @param message 日志消息内容
+     * @param file 源文件名
+     * @param line 源代码行号
+     */
+    void log(LogLevel level, const char* message, const char* file, int line) {
+        // 快速检查：级别过低则直接返回（无锁）
+        if (level < level_.load()) return;
+        log(level, message, std::strlen(message), file, line);
+    }
+
+    /**
+     * @brief 核心日志记录函数（已知消息长度）
+     * @param level 日志级别
+     * @param message 日志消息内容
+     * @param length 消息长度
+     * @param file 源文件名
+     * @param line 源代码行号
+     */
+    void log(LogLevel level, const char* message, size_t length, const char* file, int line) {
+        if (!willRecord(level)) return;
+        const LogTimestamp stamp = now();
+        log(LogRecord{level, line, file, stamp.seconds, stamp.nanos, stamp.ticks, nextSequence(),
+                      message, length, false});
+    }
+
+    /**
+     * @brief 核心日志记录函数（完整记录）
+     * @param record 日志记录，message 可以是延迟格式化的参数编码
+     */
+    void log(const LogRecord& record) {
+        if (record.level < level_.load()) return;
+
+        // 异步模式：写入环形缓冲区或有界队列，不加锁、不做 I/O
+        switch (mode_.load(std::memory_order_acquire)) {
+            case AsyncMode::ThreadRings:
+                enqueue(record);
+                return;
+            case AsyncMode::BoundedQueue:
+                enqueueBounded(record);
+                return;
+            default:
+                break;
+        }
+
+        dispatch(record);
+    }
+
+    // 静态辅助方法：创建流式日志接口
+    static LogStreamFor<DEBUG> debug(const std::source_location& loc = std::source_location::current());
+    static LogStreamFor<INFO> info(const std::source_location& loc = std::source_location::current());
+    static LogStreamFor<WARNING> warning(const std::source_location& loc = std::source_location::current());
+    static LogStreamFor<ERROR> error(const std::source_location& loc = std::source_location::current());
+    static LogStreamFor<ERROR> fatal(const std::source_location& loc = std::source_location::current());
+
+    // 静态辅助方法：{} 格式化接口，格式字符串在编译期检查，调用位置由其隐式构造捕获
+    template <typename... Args>
+    static void debugf(const LogFormatString<std::type_identity_t<Args>...>& fmt, const Args&... args);
+    template <typename... Args>
+    static void infof(const LogFormatString<std::type_identity_t<Args>...>& fmt, const Args&... args);
+    template <typename... Args>
+    static void warningf(const LogFormatString<std::type_identity_t<Args>...>& fmt, const Args&... args);
+    template <typename... Args>
+    static void errorf(const LogFormatString<std::type_identity_t<Args>...>& fmt, const Args&... args);
+    template <typename... Args>
+    static void fatalf(const LogFormatString<std::type_identity_t<Args>...>& fmt, const Args&... args);
+
+    // 流操纵符
+    static constexpr StdManipulator endl{StdManipulator::Endl};
+    static constexpr StdManipulator flush{StdManipulator::Flush};
+
+    static constexpr size_t DEFAULT_RING_CAPACITY = 1 << 20; ///< 默认每线程环形缓冲区大小（1 MiB）
+    static constexpr size_t DEFAULT_QUEUE_CAPACITY = 1024;   ///< 默认有界队列槽位数
+    static constexpr size_t DEFAULT_FILE_BUFFER_SIZE = FileSink::DEFAULT_BUFFER_SIZE; ///< 默认文件后端缓冲区大小（4 MiB）
+
+private:
+    /**
+     * @brief 异步模式
+     */
+    enum class AsyncMode {
+        Off,          ///< 同步写出
+        ThreadRings,  ///< 每线程 SPSC 环形缓冲区
+        BoundedQueue  ///< 共享有界 MPSC 队列
+    };
+
+    /**
+     * @brief 线程退出时回收本线程环形缓冲区
+     */
+    struct ThreadRingHandle {
+        std::shared_ptr<LogRingBuffer> ring;
+        ~ThreadRingHandle() {
+            if (ring) ring->retire();
+        }
+    };
+
+    using SinkList = std::vector<std::shared_ptr<LogSink>>; ///< 输出目标列表
+
+    /**
+     * @brief 为函数形式的格式化调用点登记的描述符及其行前缀缓存
+     */
+    struct FormatSite {
+        LogSitePrefix prefix; ///< 行前缀缓存
+        LogSite site{};       ///< 描述符（prefix 指向上面的缓存）
+    };
+    using FormatSiteKey = std::tuple<uintptr_t, uintptr_t, int, int>; ///< (格式串, 文件名, 行号, 级别)
+
+    std::mutex mutex_;           ///< 互斥锁，保护输出目标配置
+    static inline std::atomic<LogLevel> level_{LogLevel::INFO}; ///< 日志级别（静态成员，isEnabled 无需取单例）
+    bool consoleEnabled_;        ///< 是否输出到控制台
+    bool fileEnabled_;           ///< 是否启用文件输出
+    std::shared_ptr<ConsoleSink> consoleSink_; ///< 内置控制台输出
+    std::shared_ptr<FileSink> fileSink_;       ///< 内置文件输出
+    SinkList sinks_;             ///< 通过 addSink 注册的附加输出目标
+    std::shared_ptr<const SinkList> activeSinks_; ///< 当前生效的输出目标（写时复制）
+    std::atomic<uint64_t> sinksVersion_; ///< activeSinks_ 变更计数，写出线程据此刷新缓存
+    LogRenderer batch_;          ///< 后台线程的渲染批次（仅后台线程或其停止后的调用方访问）
+    std::atomic<bool> deferred_; ///< 是否启用延迟格式化
+    std::atomic<TimePrecision> timePrecision_; ///< 时间戳精度
+    std::atomic<TimeZoneMode> timeZone_;       ///< 时间戳与文件轮转使用的时区
+    std::atomic<ClockSource> clockSource_;     ///< 调用点时间来源
+    std::atomic<bool> sequenceEnabled_;        ///< 是否启用全局序号
+    std::atomic<uint64_t> sequence_;           ///< 最近分配的全局序号
+    LogTickClock tickClock_;                   ///< 周期计数到墙上时间的换算
+    std::mutex sitesMutex_;                    ///< 保护 formatSites_
+    std::map<FormatSiteKey, FormatSite> formatSites_; ///< 函数形式格式化调用点的描述符（保留到析构）
+
+    std::mutex asyncMutex_;                  ///< 串行化异步模式切换
+    std::atomic<AsyncMode> mode_;            ///< 当前异步模式
+    std::atomic<size_t> ringCapacity_;       ///< 新建环形缓冲区的容量
+    std::mutex ringsMutex_;                  ///< 保护 rings_（仅在线程首次注册时竞争）
+    std::vector<std::shared_ptr<LogRingBuffer>> rings_; ///< 所有生产线程的环形缓冲区
+    std::atomic<uint64_t> ringsVersion_;     ///< rings_ 变更计数，后台线程据此刷新快照
+    std::thread backend_;                    ///< 后台写出线程
+    std::atomic<bool> backendStop_;          ///< 通知后台线程退出
+    std::mutex backendMutex_;                ///< 配合 backendCv_ 使用
+    std::condition_variable backendCv_;      ///< 空闲的后台线程在此等待
+    std::atomic<bool> backendParked_;        ///< 后台线程是否正在等待 backendCv_
+    std::mutex drainMutex_;                  ///< 配合 drainCv_ 使用
+    std::condition_variable drainCv_;        ///< drain() 等待完成通知
+    std::atomic<uint64_t> drainRequested_;   ///< 已请求的 drain 序号
+    std::atomic<uint64_t> drainCompleted_;   ///< 已完成的 drain 序号
+    std::atomic<LogBoundedQueue*> queue_;    ///< 当前有界队列
+    std::vector<std::unique_ptr<LogBoundedQueue>> queues_; ///< 所有创建过的有界队列（析构时释放）
+    std::atomic<OverflowPolicy> overflowPolicy_; ///< 有界队列写满策略
+    std::atomic<LogLevel> dropBelow_;        ///< DropBelowLevel 策略的级别阈值
+    std::atomic<uint64_t> dropped_[4];       ///< 按级别统计的丢弃数
+    uint64_t droppedReported_;               ///< 已汇报的丢弃总数（仅后台线程访问）
+    std::chrono::steady_clock::time_point lastDropReport_; ///< 上次汇报丢弃的时间
+
+    static constexpr auto BACKEND_IDLE_SLEEP = std::chrono::microseconds(200); ///< 后台线程首次空闲等待
+    static constexpr auto BACKEND_MAX_IDLE_SLEEP = std::chrono::milliseconds(20); ///< 空闲等待的退避上限
+    static constexpr auto DROP_REPORT_INTERVAL = std::chrono::seconds(1);      ///< 丢弃汇报周期
+    static constexpr size_t BATCH_BYTES = 64 * 1024;                           ///< 后台线程单批投递的字节上限
+    static constexpr size_t SITE_CACHE_SIZE = 256;                             ///< 每线程调用点描述符缓存的槽位数（2 的幂）
+
+    /**
+     * @brief 私有构造函数（单例模式）
+     */
+    Logger()
+        : consoleEnabled_(true), fileEnabled_(false),
+          consoleSink_(std::make_shared<ConsoleSink>()), fileSink_(std::make_shared<FileSink>()),
+          sinksVersion_(0), deferred_(false), timePrecision_(TimePrecision::Seconds),
+          timeZone_(TimeZoneMode::Local),
+          clockSource_(ClockSource::Realtime), sequenceEnabled_(false), sequence_(0),
+          mode_(AsyncMode::Off), ringCapacity_(DEFAULT_RING_CAPACITY), ringsVersion_(0),
+          backendStop_(false), backendParked_(false), drainRequested_(0), drainCompleted_(0),
+          queue_(nullptr), overflowPolicy_(OverflowPolicy::Block),
+          dropBelow_(LogLevel::WARNING), dropped_{}, droppedReported_(0) {
+        publishSinks();
+    }
+
+    /**
+     * @brief 析构函数
+     */
+    ~Logger() {
+        {
+            std::lock_guard<std::mutex> lock(asyncMutex_);
+            switchMode(AsyncMode::Off);
+        }
+        fileSink_->close();
+    }
+
+    // 禁止拷贝和赋值
+    Logger(const Logger&) = delete;
+    Logger& operator=(const Logger&) = delete;
+
+    /**
+     * @brief 重建生效的输出目标列表（调用方需持有 mutex_）
+     */
+    void publishSinks() {
+        auto active = std::make_shared<SinkList>();
+        if (consoleEnabled_) active->push_back(consoleSink_);
+        if (fileEnabled_ && fileSink_->isOpen()) active->push_back(fileSink_);
+        active->insert(active->end(), sinks_.begin(), sinks_.end());
+        activeSinks_ = std::move(active);
+        sinksVersion_.fetch_add(1, std::memory_order_release);
+    }
+
+    /**
+     * @brief 获取当前线程缓存的输出目标列表
+     * @details 只在 sinksVersion_ 变化时加锁复制，日志热路径上仅一次原子读
+     */
+    const SinkList& currentSinks() {
+        struct Cache {
+            uint64_t version = ~uint64_t(0);
+            std::shared_ptr<const SinkList> sinks;
+        };
+        thread_local Cache cache;
+        if (sinksVersion_.load(std::memory_order_acquire) != cache.version) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            cache.sinks = activeSinks_;
+            cache.version = sinksVersion_.load(std::memory_order_relaxed);
+        }
+        return *cache.sinks;
+    }
 
-// 前置声明
-class LogStream;
+    /**
+     * @brief 函数形式格式化调用点（Logger::infof 等）的描述符
+     * @details 这些调用没有宏展开处的静态存储，首次调用时按 (级别, 文件, 行号, 格式串) 登记一个描述符
+     *          及其行前缀缓存，保留到 Logger 析构，之后与 LOG_*F 宏一样整段复制行前缀。
+     *          每个线程先查一个直接映射的小缓存，命中时不加锁也不取单例
+     */
+    template <typename... Args>
+    static const LogSite& formatSite(LogLevel level, const LogFormatString<Args...>& fmt) {
+        return formatSite(level, fmt.text().data(), fmt.file(), fmt.line(), fmt.function());
+    }
 
-/**
- * @brief 标准流操纵符包装类
- * @details 用于支持 endl、flush 等流操纵符
- */
-class StdManipulator {
-public:
-    enum Type {
-        Endl,   ///< 换行符
-        Flush,  ///< 刷新（仅换行，实际刷新在析构时完成）
-        None    ///< 无操作
-    };
+    static const LogSite& formatSite(LogLevel level, const char* format, const char* file, int line,
+                                     std::string_view function) {
+        struct Slot {
+            const char* format;
+            const char* file;
+            int line;
+            LogLevel level;
+            const LogSite* site;
+        };
+        thread_local Slot cache[SITE_CACHE_SIZE] = {};
+        const uintptr_t key = reinterpret_cast<uintptr_t>(format) ^ (static_cast<uintptr_t>(line) << 2) ^ level;
+        Slot& slot = cache[(key ^ (key >> 10)) & (SITE_CACHE_SIZE - 1)];
+        if (slot.site && slot.format == format && slot.file == file && slot.line == line && slot.level == level) {
+            return *slot.site;
+        }
 
-    constexpr StdManipulator(Type type = None) : type_(type) {}
+        Logger& logger = getInstance();
+        std::lock_guard<std::mutex> lock(logger.sitesMutex_);
+        auto [it, inserted] = logger.formatSites_.try_emplace(
+            FormatSiteKey{reinterpret_cast<uintptr_t>(format), reinterpret_cast<uintptr_t>(file), line, level});
+        FormatSite& entry = it->second;
+        if (inserted) {
+            entry.site = LogSite{level, line, file, function, format, &entry.prefix};
+        }
+        slot = Slot{format, file, line, level, &entry.site};
+        return entry.site;
+    }
 
-    constexpr Type getType() const { return type_; }
+    /**
+     * @brief 是否有输出目标接收该级别（全部拒绝时不必渲染）
+     */
+    static bool anyAccepts(const SinkList& sinks, LogLevel level) {
+        for (const auto& sink : sinks) {
+            if (sink->accepts(level)) return true;
+        }
+        return false;
+    }
 
-private:
-    Type type_;
-};
+    /**
+     * @brief 把一批日志行按各 sink 的级别分发出去
+     * @details 批次中所有行都满足某个 sink 的级别时整批交给它，否则只交出满足的部分
+     */
+    static void deliver(std::span<const LogLine> lines, const SinkList& sinks) {
+        if (lines.empty()) return;
 
-/**
- * @brief 全局 endl 操纵符
- * @details 用法：Logger::info() << "message" << ::endl;
- */
-constexpr StdManipulator endl(StdManipulator::Endl);
+        LogLevel lowest = lines.front().level;
+        for (const LogLine& line : lines) {
+            lowest = std::min(lowest, line.level);
+        }
 
-/**
- * @brief 全局 flush 操纵符
- * @details 用法：Logger::info() << "message" << ::flush;
- */
-constexpr StdManipulator flush(StdManipulator::Flush);
+        thread_local std::vector<LogLine> filtered;
+        for (const auto& sink : sinks) {
+            const LogLevel level = sink->getLevel();
+            if (lowest >= level) {
+                sink->consume(lines);
+                continue;
+            }
+            filtered.clear();
+            for (const LogLine& line : lines) {
+                if (line.level >= level) filtered.push_back(line);
+            }
+            if (!filtered.empty()) sink->consume(filtered);
+        }
+    }
 
-/**
- * @brief Logger 日志类（单例模式）
- * @details 线程安全的日志记录器，支持：
- *          - 控制台彩色输出
- *          - 文件日志记录（按日期自动轮转）
- *          - 日志级别过滤
- *          - 使用 std::atomic 和 std::mutex 保证线程安全
- */
-class Logger {
-public:
     /**
-     * @brief 获取 Logger 单例实例
-     * @return Logger 实例的引用
+     * @brief 在调用线程渲染并写出一条记录（同步路径）
      */
-    static Logger& getInstance() {
-        static Logger instance;
-        return instance;
+    void dispatch(const LogRecord& record) {
+        const SinkList& sinks = currentSinks();
+        if (!anyAccepts(sinks, record.level)) return;
+
+        thread_local LogRenderer renderer;
+        renderer.clear();
+        renderer.append(resolveTime(record), timePrecision_.load(std::memory_order_relaxed),
+                        timeZone_.load(std::memory_order_relaxed));
+        deliver(renderer.lines(), sinks);
     }
 
     /**
-     * @brief 设置日志级别
-     * @param level 日志级别，低于此级别的日志将被过滤
+     * @brief 把调用点记录的原始周期计数换算为墙上时间
      */
-    void setLevel(LogLevel level) {
-        level_.store(level);
+    LogRecord resolveTime(const LogRecord& record) {
+        LogRecord resolved = record;
+        if (record.ticks != 0) {
+            const LogTimestamp wall = tickClock_.toWall(record.ticks);
+            resolved.time = wall.seconds;
+            resolved.nanos = wall.nanos;
+            resolved.ticks = 0;
+        }
+        return resolved;
     }
 
     /**
-     * @brief 获取当前日志级别
-     * @return 当前日志级别
+     * @brief 把一条记录加入后台线程的渲染批次，达到 BATCH_BYTES 时投递
      */
-    LogLevel getLevel() const {
-        return level_.load();
+    void batchRecord(const LogRecord& record, const SinkList& sinks) {
+        if (!anyAccepts(sinks, record.level)) return;
+        batch_.append(resolveTime(record), timePrecision_.load(std::memory_order_relaxed),
+                      timeZone_.load(std::memory_order_relaxed));
+        if (batch_.bytes() >= BATCH_BYTES) {
+            flushBatch(sinks);
+        }
     }
 
     /**
-     * @brief 设置是否输出到控制台
-     * @param console true 启用控制台输出，false 禁用
+     * @brief 投递并清空后台线程的渲染批次
      */
-    void setConsole(bool console) {
-        std::lock_guard<std::mutex> lock(mutex_);
-        console_ = console;
+    void flushBatch(const SinkList& sinks) {
+        if (batch_.size() == 0) return;
+        deliver(batch_.lines(), sinks);
+        batch_.clear();
     }
 
     /**
-     * @brief 设置文件日志输出
-     * @param enable true 启用文件输出，false 禁用
-     * @param filePath 日志文件路径，文件名会自动添加日期后缀（如：-20260218.log）
+     * @brief 提交所有输出目标中缓冲的数据
      */
-    void setFile(bool enable, const std::string& filePath) {
-        std::lock_guard<std::mutex> lock(mutex_);
-        fileEnabled_ = enable;
-        baseFilePath_ = filePath;
-
-        if (enable && !baseFilePath_.empty()) {
-            openLogFile();
-        } else {
-            closeLogFile();
+    void flushSinks() {
+        for (const auto& sink : currentSinks()) {
+            sink->flush();
         }
     }
 
     /**
-     * @brief 核心日志记录函数
-     * @param level 日志级别
-     * @param message 日志消息内容
-     * @param file 源文件名
-     * @param line 源代码行号
+     * @brief 执行所有输出目标按时间触发的提交
      */
-    void log(LogLevel level, const char* message, const char* file, int line) {
-        // 快速检查：级别过低则直接返回（无锁）
-        if (level < level_.load()) return;
+    void flushSinksIfDue() {
+        for (const auto& sink : currentSinks()) {
+            sink->flushIfDue();
+        }
+    }
 
-        std::lock_guard<std::mutex> lock(mutex_);
+    /**
+     * @brief 获取（必要时创建并注册）当前线程的环形缓冲区
+     */
+    LogRingBuffer& threadRing() {
+        thread_local ThreadRingHandle handle;
+        if (!handle.ring) {
+            handle.ring = std::make_shared<LogRingBuffer>(ringCapacity_.load());
+            std::lock_guard<std::mutex> lock(ringsMutex_);
+            rings_.push_back(handle.ring);
+            ringsVersion_.fetch_add(1, std::memory_order_release);
+        }
+        return *handle.ring;
+    }
 
-        // 时间处理（缓存优化，同一秒内不重复格式化）
-        std::time_t now = std::time(nullptr);
-        if (now != lastTime_) {
-            updateTimeStr(now);
-            lastTime_ = now;
+    /**
+     * @brief 异步模式下提交一条记录
+     * @details 缓冲区满时让出 CPU 等待后台线程排空；
+     *          超长记录或模式已关闭时退回同步写出
+     */
+    void enqueue(const LogRecord& record) {
+        LogRingBuffer& ring = threadRing();
+        if (record.length <= ring.maxMessageLength()) {
+            while (!ring.tryPush(record)) {
+                if (mode_.load(std::memory_order_acquire) != AsyncMode::ThreadRings) break;
+                wakeBackend();
+                std::this_thread::yield();
+            }
+            if (mode_.load(std::memory_order_relaxed) == AsyncMode::ThreadRings) {
+                wakeBackend();
+                return;
+            }
         }
 
-        // 1. 控制台输出（带颜色）
-        if (console_) {
-            const char* color = logLevelToColorCode(level);
-            const char* reset = "\033[0m";
-            const char* levelStr = logLevelToString(level);
+        dispatch(record);
+    }
 
-            // 格式：YYYY-MM-DD HH:MM:SS [LEVEL] file:line - message
-            fprintf(stdout, "%s [%s%s%s] %s:%d - %s\n",
-                    timeStr_, color, levelStr, reset, file, line, message);
-        }
+    /**
+     * @brief 有界队列模式下提交一条记录
+     * @details 按 overflowPolicy_ 处理队列已满的情况；
+     *          超过槽位大小的记录或模式已关闭时退回同步写出
+     */
+    void enqueueBounded(const LogRecord& record) {
+        LogBoundedQueue* queue = queue_.load(std::memory_order_acquire);
+        if (record.length <= LogBoundedQueue::SLOT_MESSAGE_SIZE) {
+            const OverflowPolicy policy = overflowPolicy_.load(std::memory_order_relaxed);
+            while (!queue->tryPush(record)) {
+                if (mode_.load(std::memory_order_acquire) != AsyncMode::BoundedQueue) break;
 
-        // 2. 文件输出
-        if (fileEnabled_ && fileHandle_) {
-            // 检查是否需要轮转（超过 24 小时）
-            if (now - fileOpenTime_ > 60 * 60 * 24) {
-                openLogFile(); // 重新打开文件（触发轮转）
+                if (policy == OverflowPolicy::DropNewest ||
+                    (policy == OverflowPolicy::DropBelowLevel &&
+                     record.level < dropBelow_.load(std::memory_order_relaxed))) {
+                    dropped_[record.level].fetch_add(1, std::memory_order_relaxed);
+                    return;
+                }
+                if (policy == OverflowPolicy::DropOldest) {
+                    queue->tryPop([this](const LogRecord& oldest) {
+                        dropped_[oldest.level].fetch_add(1, std::memory_order_relaxed);
+                    });
+                    continue;
+                }
+                wakeBackend();
+                std::this_thread::yield();
             }
-
-            // 文件句柄无效时尝试重新打开
-            if (!fileHandle_) {
-                openLogFile();
+            if (mode_.load(std::memory_order_relaxed) == AsyncMode::BoundedQueue) {
+                wakeBackend();
+                return;
             }
+        }
 
-            if (fileHandle_) {
-                fprintf(fileHandle_, "%s [%s] %s:%d - %s\n",
-                        timeStr_, logLevelToString(level), file, line, message);
-                fflush(fileHandle_); // 确保数据写入磁盘
-            }
+        dispatch(record);
+    }
+
+    /**
+     * @brief 排空有界队列
+     * @return 写出的记录条数
+     */
+    size_t drainQueue() {
+        LogBoundedQueue* queue = queue_.load(std::memory_order_acquire);
+        if (!queue) return 0;
+
+        const SinkList& sinks = currentSinks();
+        size_t total = 0;
+        while (queue->tryPop([&](const LogRecord& record) { batchRecord(record, sinks); })) {
+            ++total;
         }
+        flushBatch(sinks);
+        return total;
     }
 
-    // 静态辅助方法：创建流式日志接口
-    static LogStream debug(const std::source_location& loc = std::source_location::current());
-    static LogStream info(const std::source_location& loc = std::source_location::current());
-    static LogStream warning(const std::source_location& loc = std::source_location::current());
-    static LogStream error(const std::source_location& loc = std::source_location::current());
-    static LogStream fatal(const std::source_location& loc = std::source_location::current());
+    /**
+     * @brief 汇报自上次汇报以来被丢弃的记录数
+     * @param force true 时忽略汇报周期
+     */
+    void reportDrops(bool force) {
+        const auto now = std::chrono::steady_clock::now();
+        if (!force && now - lastDropReport_ < DROP_REPORT_INTERVAL) return;
+        lastDropReport_ = now;
 
-    // 流操纵符
-    static constexpr StdManipulator endl{StdManipulator::Endl};
-    static constexpr StdManipulator flush{StdManipulator::Flush};
+        const uint64_t total = droppedCount();
+        if (total == droppedReported_) return;
 
-private:
-    std::mutex mutex_;           ///< 互斥锁，保护共享状态
-    std::atomic<LogLevel> level_; ///< 原子变量，日志级别（无锁读写）
-    bool console_;               ///< 是否输出到控制台
-    bool fileEnabled_;           ///< 是否启用文件输出
-    std::string baseFilePath_;   ///< 基础文件路径
-    FILE* fileHandle_;           ///< 文件句柄
-    std::time_t fileOpenTime_;   ///< 文件打开时间
-    std::time_t lastTime_;       ///< 上次更新时间字符串的时间
-    char timeStr_[32];           ///< 格式化后的时间字符串缓存
+        char message[160];
+        int length = snprintf(message, sizeof(message),
+                              "%llu records dropped (DEBUG=%llu INFO=%llu WARNING=%llu ERROR=%llu)",
+                              static_cast<unsigned long long>(total - droppedReported_),
+                              static_cast<unsigned long long>(droppedCount(DEBUG)),
+                              static_cast<unsigned long long>(droppedCount(INFO)),
+                              static_cast<unsigned long long>(droppedCount(WARNING)),
+                              static_cast<unsigned long long>(droppedCount(ERROR)));
+        droppedReported_ = total;
+        if (!anyAccepts(currentSinks(), WARNING)) return;
+
+        const LogTimestamp stamp = LogClock::now();
+        dispatch(LogRecord{WARNING, __LINE__, __FILE__, stamp.seconds, stamp.nanos, 0, nextSequence(),
+                           message, static_cast<size_t>(length), false});
+    }
 
     /**
-     * @brief 私有构造函数（单例模式）
+     * @brief 切换异步模式（调用方需持有 asyncMutex_）
      */
-    Logger()
-        : level_(LogLevel::INFO), console_(true), fileEnabled_(false),
-          fileHandle_(nullptr), fileOpenTime_(0), lastTime_(0) {
-        std::memset(timeStr_, 0, sizeof(timeStr_));
+    void switchMode(AsyncMode mode) {
+        if (mode == mode_.load()) return;
+
+        if (mode_.load() != AsyncMode::Off) {
+            mode_.store(AsyncMode::Off, std::memory_order_release);
+            stopBackend();
+        }
+        if (mode != AsyncMode::Off) {
+            backendStop_.store(false);
+            backend_ = std::thread(&Logger::backendLoop, this);
+            mode_.store(mode, std::memory_order_release);
+        }
     }
 
     /**
-     * @brief 析构函数
+     * @brief 排空给定的环形缓冲区
+     * @return 写出的记录条数
      */
-    ~Logger() {
-        closeLogFile();
+    size_t drainRings(const std::vector<std::shared_ptr<LogRingBuffer>>& rings) {
+        const SinkList& sinks = currentSinks();
+        size_t total = 0;
+        for (const auto& ring : rings) {
+            if (ring->empty()) continue;
+            total += ring->consume([&](const LogRecord& record) {
+                batchRecord(record, sinks);
+            });
+        }
+        flushBatch(sinks);
+        return total;
     }
 
-    // 禁止拷贝和赋值
-    Logger(const Logger&) = delete;
-    Logger& operator=(const Logger&) = delete;
-
     /**
-     * @brief 更新时间字符串缓存
-     * @param t 时间值
+     * @brief 获取 rings_ 的快照
      */
-    void updateTimeStr(std::time_t t) {
-        std::tm tm_buf;
-        #ifdef _WIN32
-        localtime_s(&tm_buf, &t);
-        #else
-        localtime_r(&t, &tm_buf);
-        #endif
-        std::strftime(timeStr_, sizeof(timeStr_), "%Y-%m-%d %H:%M:%S", &tm_buf);
+    std::vector<std::shared_ptr<LogRingBuffer>> snapshotRings() {
+        std::lock_guard<std::mutex> lock(ringsMutex_);
+        return rings_;
     }
 
     /**
-     * @brief 关闭日志文件
+     * @brief 移除所属线程已退出且已排空的环形缓冲区
      */
-    void closeLogFile() {
-        if (fileHandle_) {
-            fclose(fileHandle_);
-            fileHandle_ = nullptr;
+    void pruneRetiredRings() {
+        std::lock_guard<std::mutex> lock(ringsMutex_);
+        size_t before = rings_.size();
+        std::erase_if(rings_, [](const std::shared_ptr<LogRingBuffer>& ring) {
+            return ring->isRetired() && ring->empty();
+        });
+        if (rings_.size() != before) {
+            ringsVersion_.fetch_add(1, std::memory_order_release);
         }
     }
 
     /**
-     * @brief 打开日志文件（支持按日期轮转）
+     * @brief 标记 drain 请求完成并唤醒等待者
      */
-    void openLogFile() {
-        closeLogFile(); // 先关闭已存在的文件
+    void completeDrain(uint64_t ticket) {
+        if (drainCompleted_.load() >= ticket) return;
+        {
+            std::lock_guard<std::mutex> lock(drainMutex_);
+            drainCompleted_.store(ticket);
+        }
+        drainCv_.notify_all();
+    }
 
-        std::time_t now = std::time(nullptr);
-        std::tm tm_buf;
-        #ifdef _WIN32
-        localtime_s(&tm_buf, &now);
-        #else
-        localtime_r(&now, &tm_buf);
-        #endif
-        char dateSuffix[16];
-        std::strftime(dateSuffix, sizeof(dateSuffix), "-%Y%m%d.log", &tm_buf);
+    /**
+     * @brief 唤醒正在空闲等待的后台线程
+     * @param force true 时跳过 relaxed 预读（drain() 与退出请求使用，保证不错过）
+     * @details 后台线程运行时生产者只有一次 relaxed 读取，不进入内核；
+     *          只有第一个看到等待标记的线程加锁并通知
+     */
+    void wakeBackend(bool force = false) {
+        if (!force && !backendParked_.load(std::memory_order_relaxed)) return;
+        if (!backendParked_.exchange(false)) return;
+        // 加锁保证后台线程已进入 wait，通知不会丢失
+        { std::lock_guard<std::mutex> lock(backendMutex_); }
+        backendCv_.notify_one();
+    }
 
-        std::string finalPath = baseFilePath_;
-        // 在扩展名前插入日期，或在末尾添加
-        size_t dotPos = baseFilePath_.find_last_of('.');
-        if (dotPos == std::string::npos) {
-            finalPath += dateSuffix;
-        } else {
-            finalPath = baseFilePath_.substr(0, dotPos) + dateSuffix;
+    /**
+     * @brief 空闲时等待生产者唤醒，最长等待 timeout
+     * @details 生产者读取等待标记时不加内存屏障，极少数情况下会错过通知，
+     *          此时记录最迟在 timeout 后写出；drain() 与退出请求使用顺序一致的原子操作，不会错过
+     */
+    void parkBackend(std::chrono::microseconds timeout) {
+        std::unique_lock<std::mutex> lock(backendMutex_);
+        backendParked_.store(true);
+        if (backendStop_.load() || drainRequested_.load() > drainCompleted_.load()) {
+            backendParked_.store(false);
+            return;
         }
+        backendCv_.wait_for(lock, timeout, [this] { return !backendParked_.load(); });
+        backendParked_.store(false);
+    }
 
-        #ifdef _WIN32
-        fopen_s(&fileHandle_, finalPath.c_str(), "a");
-        #else
-        fileHandle_ = fopen(finalPath.c_str(), "a");
-        #endif
+    /**
+     * @brief 后台线程主循环
+     * @details 轮询所有环形缓冲区；一轮没有取到任何记录时，
+     *          说明此前提交的记录均已写出，可以完成 drain 请求或退出。
+     *          持续空闲时等待时间从 BACKEND_IDLE_SLEEP 倍增到 BACKEND_MAX_IDLE_SLEEP，
+     *          生产者写入时唤醒，空闲进程不再频繁醒来
+     */
+    void backendLoop() {
+        std::vector<std::shared_ptr<LogRingBuffer>> rings;
+        uint64_t seenVersion = ~uint64_t(0);
+        std::chrono::microseconds idleSleep = BACKEND_IDLE_SLEEP;
+
+        for (;;) {
+            const bool stopping = backendStop_.load(std::memory_order_acquire);
+            const uint64_t ticket = drainRequested_.load(std::memory_order_acquire);
 
-        if (fileHandle_) {
-            fileOpenTime_ = now;
+            const uint64_t version = ringsVersion_.load(std::memory_order_acquire);
+            if (version != seenVersion) {
+                rings = snapshotRings();
+                seenVersion = version;
+            }
+
+            size_t written = drainRings(rings) + drainQueue();
+            reportDrops(false);
+            if (written > 0) {
+                idleSleep = BACKEND_IDLE_SLEEP;
+                continue;
+            }
+
+            if (ticket > drainCompleted_.load() || stopping) {
+                flushSinks();
+            } else {
+                flushSinksIfDue();
+            }
+            completeDrain(ticket);
+            if (stopping) break;
+
+            pruneRetiredRings();
+            parkBackend(idleSleep);
+            idleSleep = std::min<std::chrono::microseconds>(idleSleep * 2, BACKEND_MAX_IDLE_SLEEP);
         }
     }
+
+    /**
+     * @brief 停止后台线程并写出残留记录
+     */
+    void stopBackend() {
+        if (!backend_.joinable()) return;
+        backendStop_.store(true);
+        wakeBackend(true);
+        backend_.join();
+
+        // 模式切换瞬间仍可能有生产者写入缓冲区，在当前线程补写一次
+        drainRings(snapshotRings());
+        drainQueue();
+        reportDrops(true);
+        flushSinks();
+        completeDrain(drainRequested_.load());
+    }
 };
 
 /**
@@ -330,17 +6123,34 @@ public:
      * @param level 日志级别
      * @param file 源文件名
      * @param line 源代码行号
+     * @details 时间戳与全局序号在此处（事件发生时）采样，而不是在析构写出时；
+     *          构造时已被级别过滤的记录不采样，析构时也不再输出
      */
     LogStream(LogLevel level, const char* file, int line)
-        : level_(level), file_(file), line_(line), offset_(0) {
-        buffer_[0] = '\0';
+        : offset_(0), level_(level), file_(file), line_(line), site_(nullptr),
+          deferred_(false), enabled_(false), stamp_{0, 0, 0}, sequence_(0) {
+        start();
+    }
+
+    /**
+     * @brief 由调用点描述符构造（LOG_* 宏使用），记录只携带描述符指针
+     * @param site 编译期生成的静态描述符
+     */
+    explicit LogStream(const LogSite& site)
+        : offset_(0), level_(site.level), file_(site.file), line_(site.line), site_(&site),
+          deferred_(false), enabled_(false), stamp_{0, 0, 0}, sequence_(0) {
+        start();
     }
 
     /**
      * @brief 析构函数：将缓冲区内容输出到 Logger
      */
     ~LogStream() {
-        Logger::getInstance().log(level_, buffer_, file_, line_);
+        if (!enabled_) return;
+        Logger& logger = Logger::getInstance();
+        if (level_ < logger.getLevel()) return;
+        logger.log(LogRecord{level_, line_, file_, stamp_.seconds, stamp_.nanos, stamp_.ticks, sequence_,
+                             buffer_, static_cast<size_t>(offset_), deferred_, site_});
     }
 
     /**
@@ -349,6 +6159,12 @@ public:
      */
     template <typename T> requires std::is_arithmetic_v<T>
     LogStream& operator<<(T val) {
+        if (!enabled_) return *this;
+        if (deferred_) {
+            offset_ += LogArgCodec::encode(buffer_ + offset_, BUFFER_SIZE - 1 - offset_, val);
+            return *this;
+        }
+
         if constexpr (std::is_same_v<T, bool>) {
             append(val ? "true" : "false");
         }
@@ -359,9 +6175,14 @@ public:
             }
         }
         else if constexpr (std::is_floating_point_v<T>) {
-            char tmp[32];
-            int len = snprintf(tmp, sizeof(tmp), "%.4f", val);
-            if (len > 0) append(tmp);
+            // 与 "%.4f" 相同的文本；超过 31 个字符时截断（与 LogArgCodec::decode 一致）
+            char tmp[400];
+            auto res = std::to_chars(tmp, tmp + sizeof(tmp) - 1, static_cast<double>(val),
+                                     std::chars_format::fixed, 4);
+            if (res.ec == std::errc()) {
+                *std::min(res.ptr, tmp + 31) = '\0';
+                append(tmp);
+            }
         }
         else {
             // 使用 std::to_chars 高效转换整数
@@ -380,7 +6201,7 @@ public:
      * @brief C 字符串输出
      */
     LogStream& operator<<(const char* val) {
-        if (val) append(val);
+        if (enabled_ && val) append(val);
         return *this;
     }
 
@@ -388,6 +6209,12 @@ public:
      * @brief std::string 输出
      */
     LogStream& operator<<(const std::string& val) {
+        if (!enabled_) return *this;
+        if (deferred_) {
+            offset_ += LogArgCodec::encode(buffer_ + offset_, BUFFER_SIZE - 1 - offset_,
+                                           val.data(), std::strlen(val.c_str()));
+            return *this;
+        }
         append(val.c_str());
         return *this;
     }
@@ -396,6 +6223,12 @@ public:
      * @brief 指针输出（十六进制格式）
      */
     LogStream& operator<<(const void* val) {
+        if (!enabled_) return *this;
+        if (deferred_) {
+            offset_ += LogArgCodec::encode(buffer_ + offset_, BUFFER_SIZE - 1 - offset_, val);
+            return *this;
+        }
+
         char tmp[32];
         snprintf(tmp, sizeof(tmp), "%p", val);
         append(tmp);
@@ -410,6 +6243,7 @@ public:
      *          使用方式：Logger::info() << "message" << Logger::endl;
      */
     LogStream& operator<<(StdManipulator manip) {
+        if (!enabled_) return *this;
         if (manip.getType() == StdManipulator::Endl ||
             manip.getType() == StdManipulator::Flush) {
             append("\n");
@@ -417,10 +6251,39 @@ public:
         return *this;
     }
 
+    /**
+     * @brief 按 {} 格式字符串追加参数，直接写入记录缓冲区
+     * @param fmt 编译期检查过的格式字符串
+     * @details 同步模式下就地转换为文本；延迟格式化模式下先预留字符串参数头部，
+     *          把文本直接格式化到其负载位置再回填长度，两种模式都不产生临时字符串
+     */
+    template <typename... Args>
+    LogStream& format(const LogFormatString<std::type_identity_t<Args>...>& fmt, const Args&... args) {
+        if (!enabled_) return *this;
+        const size_t capacity = BUFFER_SIZE - 1 - offset_;
+        if (deferred_) {
+            if (capacity <= LogArgCodec::STRING_HEADER) return *this;
+            char* payload = buffer_ + offset_ + LogArgCodec::STRING_HEADER;
+            const size_t length = LogFormatter::format(payload, capacity - LogArgCodec::STRING_HEADER,
+                                                       fmt, args...);
+            LogArgCodec::encodeStringHeader(buffer_ + offset_, length);
+            offset_ += static_cast<int>(LogArgCodec::STRING_HEADER + length);
+            return *this;
+        }
+        offset_ += static_cast<int>(LogFormatter::format(buffer_ + offset_, capacity, fmt, args...));
+        buffer_[offset_] = '\0';
+        return *this;
+    }
+
     /**
      * @brief 支持换行符字符（允许直接使用 '\n'）
      */
     LogStream& operator<<(char c) {
+        if (!enabled_) return *this;
+        if (deferred_) {
+            offset_ += LogArgCodec::encode(buffer_ + offset_, BUFFER_SIZE - 1 - offset_, c);
+            return *this;
+        }
         if (offset_ < BUFFER_SIZE - 1) {
             buffer_[offset_++] = c;
             buffer_[offset_] = '\0';
@@ -435,12 +6298,38 @@ private:
     LogLevel level_;                     ///< 日志级别
     const char* file_;                   ///< 源文件名
     int line_;                           ///< 源代码行号
+    const LogSite* site_;                ///< 调用点描述符（可能为空）
+    bool deferred_;                      ///< 是否以延迟格式化编码参数
+    bool enabled_;                       ///< 构造时是否通过级别过滤且有输出目标接收
+    LogTimestamp stamp_;                 ///< 构造时采样的时间戳
+    uint64_t sequence_;                  ///< 构造时分配的全局序号
+
+    /**
+     * @brief 通过级别过滤且有输出目标接收时采样时间戳与全局序号
+     */
+    void start() {
+        buffer_[0] = '\0';
+        if (Logger::isEnabled(level_)) {
+            Logger& logger = Logger::getInstance();
+            if (!logger.willRecord(level_)) return;
+            enabled_ = true;
+            deferred_ = logger.isDeferredFormat();
+            stamp_ = logger.now();
+            sequence_ = logger.nextSequence();
+        }
+    }
 
     /**
      * @brief 向缓冲区追加字符串
      * @param str 要追加的字符串
      */
     void append(const char* str) {
+        if (deferred_) {
+            offset_ += LogArgCodec::encode(buffer_ + offset_, BUFFER_SIZE - 1 - offset_,
+                                           str, std::strlen(str));
+            return;
+        }
+
         int len = 0;
         while (str[len] && offset_ + len < BUFFER_SIZE - 1) {
             buffer_[offset_ + len] = str[len];
@@ -451,29 +6340,91 @@ private:
     }
 };
 
+/**
+ * @brief 构造级别 Level 的日志流（编译期剔除的级别返回 LogNullStream）
+ */
+template <LogLevel Level>
+LogStreamFor<Level> makeLogStream(const char* file, int line) {
+    if constexpr (logLevelCompiled(Level)) {
+        return LogStream(Level, file, line);
+    } else {
+        return LogNullStream();
+    }
+}
+
+/**
+ * @brief 由调用点描述符构造级别 Level 的日志流
+ */
+template <LogLevel Level>
+LogStreamFor<Level> makeLogStream(const LogSite& site) {
+    if constexpr (logLevelCompiled(Level)) {
+        return LogStream(site);
+    } else {
+        return LogNullStream();
+    }
+}
+
 // Logger 静态方法的实现（需在 LogStream 定义之后）
-inline LogStream Logger::debug(const std::source_location& loc) {
-    return LogStream(DEBUG, loc.file_name(), loc.line());
+inline LogStreamFor<DEBUG> Logger::debug(const std::source_location& loc) {
+    return makeLogStream<DEBUG>(loc.file_name(), loc.line());
 }
 
-inline LogStream Logger::info(const std::source_location& loc) {
-    return LogStream(INFO, loc.file_name(), loc.line());
+inline LogStreamFor<INFO> Logger::info(const std::source_location& loc) {
+    return makeLogStream<INFO>(loc.file_name(), loc.line());
 }
 
-inline LogStream Logger::warning(const std::source_location& loc) {
-    return LogStream(WARNING, loc.file_name(), loc.line());
+inline LogStreamFor<WARNING> Logger::warning(const std::source_location& loc) {
+    return makeLogStream<WARNING>(loc.file_name(), loc.line());
 }
 
-inline LogStream Logger::error(const std::source_location& loc) {
-    return LogStream(ERROR, loc.file_name(), loc.line());
+inline LogStreamFor<ERROR> Logger::error(const std::source_location& loc) {
+    return makeLogStream<ERROR>(loc.file_name(), loc.line());
 }
 
-inline LogStream Logger::fatal(const std::source_location& loc) {
-    LogStream stream(ERROR, loc.file_name(), loc.line());
+inline LogStreamFor<ERROR> Logger::fatal(const std::source_location& loc) {
+    LogStreamFor<ERROR> stream = makeLogStream<ERROR>(loc.file_name(), loc.line());
     stream << "FATAL ERROR: ";
     return stream;
 }
 
+// {} 格式化接口的实现：按调用点描述符构造日志流（行前缀可缓存），级别被过滤时 format() 不格式化任何参数
+template <typename... Args>
+inline void Logger::debugf(const LogFormatString<std::type_identity_t<Args>...>& fmt, const Args&... args) {
+    if constexpr (logLevelCompiled(DEBUG)) {
+        LogStream(formatSite(DEBUG, fmt)).format(fmt, args...);
+    }
+}
+
+template <typename... Args>
+inline void Logger::infof(const LogFormatString<std::type_identity_t<Args>...>& fmt, const Args&... args) {
+    if constexpr (logLevelCompiled(INFO)) {
+        LogStream(formatSite(INFO, fmt)).format(fmt, args...);
+    }
+}
+
+template <typename... Args>
+inline void Logger::warningf(const LogFormatString<std::type_identity_t<Args>...>& fmt, const Args&... args) {
+    if constexpr (logLevelCompiled(WARNING)) {
+        LogStream(formatSite(WARNING, fmt)).format(fmt, args...);
+    }
+}
+
+template <typename... Args>
+inline void Logger::errorf(const LogFormatString<std::type_identity_t<Args>...>& fmt, const Args&... args) {
+    if constexpr (logLevelCompiled(ERROR)) {
+        LogStream(formatSite(ERROR, fmt)).format(fmt, args...);
+    }
+}
+
+template <typename... Args>
+inline void Logger::fatalf(const LogFormatString<std::type_identity_t<Args>...>& fmt, const Args&... args) {
+    if constexpr (logLevelCompiled(ERROR)) {
+        LogStream stream(formatSite(ERROR, fmt));
+        stream << "FATAL ERROR: ";
+        stream.format(fmt, args...);
+    }
+}
+
 /**
  * @brief 日志快捷宏
  * @details 提供更简洁的日志调用方式
@@ -481,17 +6432,43 @@ inline LogStream Logger::fatal(const std::source_location& loc) {
  *          也可以直接使用函数风格：log_debug("message"，42, true)
  */
 
+/**
+ * @brief 把整条 `LogStream << ...` 链吞成 void 表达式，供 LOGGER_STREAM_IF 的条件运算符使用
+ * @details operator& 的优先级低于 operator<<，右侧整条链先结合
+ */
+struct LogVoidify {
+    void operator&(const LogStream&) const {}
+    void operator&(const LogNullStream&) const {}
+};
+
+/**
+ * @brief 级别守卫：级别被过滤时既不构造 LogStream，也不求值 << 右侧的任何参数
+ * @details 展开为单个表达式，可安全用于不带花括号的 if/else 分支；
+ *          低于 LOGGER_ACTIVE_LEVEL 的级别条件为编译期常量，整条调用被编译器删除
+ */
+#define LOGGER_STREAM_IF(level, stream) \
+    !Logger::isEnabled(level) ? (void)0 : LogVoidify() & stream
+
 // 宏定义（兼容旧版本）
 #ifndef LOGGER_NO_MACROS
-    #define LOG_DEBUG   Logger::debug()
-    #define LOG_INFO    Logger::info()
-    #define LOG_WARNING Logger::warning()
-    #define LOG_ERROR   Logger::error()
-    #define LOG_FATAL   Logger::fatal()
+    #define LOGGER_SITE_STREAM(level) makeLogStream<level>(LOGGER_SITE(level, nullptr))
+    #define LOG_DEBUG   LOGGER_STREAM_IF(LogLevel::DEBUG, LOGGER_SITE_STREAM(LogLevel::DEBUG))
+    #define LOG_INFO    LOGGER_STREAM_IF(LogLevel::INFO, LOGGER_SITE_STREAM(LogLevel::INFO))
+    #define LOG_WARNING LOGGER_STREAM_IF(LogLevel::WARNING, LOGGER_SITE_STREAM(LogLevel::WARNING))
+    #define LOG_ERROR   LOGGER_STREAM_IF(LogLevel::ERROR, LOGGER_SITE_STREAM(LogLevel::ERROR))
+    #define LOG_FATAL   LOGGER_STREAM_IF(LogLevel::ERROR, LOGGER_SITE_STREAM(LogLevel::ERROR) << "FATAL ERROR: ")
     #define LOG_ENDL    Logger::endl
+
+    // {} 格式化宏：使用静态调用点描述符（含行前缀缓存），级别被过滤时不求值参数
+    #define LOGGER_SITE_FORMAT(level, fmt, ...) LOGGER_STREAM_IF(level, \
+        makeLogStream<level>(LOGGER_SITE(level, fmt)).format(fmt __VA_OPT__(,) __VA_ARGS__))
+    #define LOG_DEBUGF(fmt, ...)   LOGGER_SITE_FORMAT(LogLevel::DEBUG, fmt __VA_OPT__(,) __VA_ARGS__)
+    #define LOG_INFOF(fmt, ...)    LOGGER_SITE_FORMAT(LogLevel::INFO, fmt __VA_OPT__(,) __VA_ARGS__)
+    #define LOG_WARNINGF(fmt, ...) LOGGER_SITE_FORMAT(LogLevel::WARNING, fmt __VA_OPT__(,) __VA_ARGS__)
+    #define LOG_ERRORF(fmt, ...)   LOGGER_SITE_FORMAT(LogLevel::ERROR, fmt __VA_OPT__(,) __VA_ARGS__)
 #endif
 
-// 命名空间别名 - 使用代理模式支持 lg::info << "message" 语法，这会导致source_location
+// 命名空间别名 - 使用代理模式支持 lg::info << "message" 语法，调用位置由首个参数的隐式转换捕获
 namespace lg {
     // 日志级别标记类型
     struct DebugTag { constexpr DebugTag() = default; };
@@ -500,18 +6477,42 @@ namespace lg {
     struct ErrorTag { constexpr ErrorTag() = default; };
     struct FatalTag { constexpr FatalTag() = default; };
 
+    // 代理的首个参数 - 隐式转换时通过默认实参捕获调用方（lg::info << ... 所在行）的位置
+    class LogProxyArg {
+    public:
+        template<typename T>
+        LogProxyArg(const T& value, const std::source_location& loc = std::source_location::current())
+            : value_(&value), emit_(&emit<T>), loc_(loc) {}
+
+        const std::source_location& location() const { return loc_; }
+
+        // 把参数输出到 stream
+        void writeTo(LogStream& stream) const { emit_(stream, value_); }
+
+    private:
+        template<typename T>
+        static void emit(LogStream& stream, const void* value) {
+            stream << *static_cast<const T*>(value);
+        }
+
+        const void* value_;                          // 参数地址（仅在整条语句期间有效）
+        void (*emit_)(LogStream&, const void*);      // 按参数原类型输出
+        std::source_location loc_;                   // 调用方位置
+    };
+
     // 日志代理 - 首次使用 operator<< 时创建 LogStream
     template<LogLevel Level>
     class LogProxy {
     public:
         constexpr LogProxy() = default;
 
-        // 创建并返回 LogStream，支持链式调用
-        template<typename T>
-        LogStream operator<<(const T& val) const {
-            auto loc = std::source_location::current();
-            LogStream stream(Level, loc.file_name(), loc.line());
-            stream << val;
+        // 创建并返回 LogStream，支持链式调用（编译期剔除的级别返回 LogNullStream）
+        LogStreamFor<Level> operator<<(const LogProxyArg& arg) const {
+            const std::source_location& loc = arg.location();
+            LogStreamFor<Level> stream = makeLogStream<Level>(loc.file_name(), loc.line());
+            if constexpr (logLevelCompiled(Level)) {
+                arg.writeTo(stream);
+            }
             return stream;
         }
     };
@@ -534,30 +6535,45 @@ namespace logger {
 }
 
 // C++20 概念约束的简化版本
-// 支持函数风格的调用：log_debug("message")
+// 支持函数风格的调用：log_debug("message")，级别被过滤时直接返回，不格式化任何参数
 template<typename... Args>
 void log_debug(Args&&... args) {
-    (Logger::debug() << ... << std::forward<Args>(args));
+    if constexpr (logLevelCompiled(LogLevel::DEBUG)) {
+        if (!Logger::isEnabled(LogLevel::DEBUG)) return;
+        (Logger::debug() << ... << std::forward<Args>(args));
+    }
 }
 
 template<typename... Args>
 void log_info(Args&&... args) {
-    (Logger::info() << ... << std::forward<Args>(args));
+    if constexpr (logLevelCompiled(LogLevel::INFO)) {
+        if (!Logger::isEnabled(LogLevel::INFO)) return;
+        (Logger::info() << ... << std::forward<Args>(args));
+    }
 }
 
 template<typename... Args>
 void log_warning(Args&&... args) {
-    (Logger::warning() << ... << std::forward<Args>(args));
+    if constexpr (logLevelCompiled(LogLevel::WARNING)) {
+        if (!Logger::isEnabled(LogLevel::WARNING)) return;
+        (Logger::warning() << ... << std::forward<Args>(args));
+    }
 }
 
 template<typename... Args>
 void log_error(Args&&... args) {
-    (Logger::error() << ... << std::forward<Args>(args));
+    if constexpr (logLevelCompiled(LogLevel::ERROR)) {
+        if (!Logger::isEnabled(LogLevel::ERROR)) return;
+        (Logger::error() << ... << std::forward<Args>(args));
+    }
 }
 
 template<typename... Args>
 void log_fatal(Args&&... args) {
-    (Logger::fatal() << ... << std::forward<Args>(args));
+    if constexpr (logLevelCompiled(LogLevel::ERROR)) {
+        if (!Logger::isEnabled(LogLevel::ERROR)) return;
+        (Logger::fatal() << ... << std::forward<Args>(args));
+    }
 }
 
 #endif // C_LOGGER_HPP
@@ -0,0 +1,18 @@
+// Compiled with LOGGER_ACTIVE_LEVEL=LOGGER_LEVEL_INFO and never linked:
+// test_log_level.cpp inspects the object file for traces of the DEBUG calls below.
+#include "Logger.hpp"
+
+int probe_debug_argument();
+int probe_info_argument();
+
+void strip_level_probe(int value) {
+    Logger::debug() << "probe stream debug marker " << value;
+    LOG_DEBUG << "probe macro debug marker " << probe_debug_argument();
+    lg::debug << "probe proxy debug marker " << value;
+    log_debug("probe function debug marker ", value);
+    if (Logger::isEnabled(LogLevel::DEBUG)) {
+        Logger::getInstance().log(LogLevel::DEBUG, "probe guarded debug marker", __FILE__, __LINE__);
+    }
+
+    LOG_INFO << "probe macro info marker " << probe_info_argument();
+}
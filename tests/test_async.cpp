@@ -0,0 +1,325 @@
+#include <gtest/gtest.h>
+#include "Logger.hpp"
+#include "test_utils/test_helpers.hpp"
+#include <thread>
+#include <vector>
+#include <sstream>
+#include <algorithm>
+
+class AsyncModeTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        Logger::getInstance().setLevel(LogLevel::DEBUG);
+        Logger::getInstance().setConsole(false);
+    }
+
+    void TearDown() override {
+        Logger::getInstance().setAsync(false);
+        Logger::getInstance().setBoundedQueue(false);
+        Logger::getInstance().setFile(false, "");
+        Logger::getInstance().setConsole(true);
+        cleanup_temp_logs();
+    }
+
+    void cleanup_temp_logs() {
+        auto temp_dir = std::filesystem::temp_directory_path();
+        for (const auto& entry : std::filesystem::directory_iterator(temp_dir)) {
+            std::string filename = entry.path().filename().string();
+            if (filename.find("async_") == 0) {
+                std::filesystem::remove(entry.path());
+            }
+        }
+    }
+
+    // Concatenate all log files starting with prefix
+    std::string read_logs(const std::string& prefix) {
+        std::string content;
+        auto temp_dir = std::filesystem::temp_directory_path();
+        for (const auto& entry : std::filesystem::directory_iterator(temp_dir)) {
+            if (entry.path().filename().string().find(prefix) == 0) {
+                std::ifstream file(entry.path());
+                std::stringstream buffer;
+                buffer << file.rdbuf();
+                content += buffer.str();
+            }
+        }
+        return content;
+    }
+
+    size_t count_lines(const std::string& content) {
+        return static_cast<size_t>(std::count(content.begin(), content.end(), '\n'));
+    }
+};
+
+// Test 1: Enable and disable async mode
+TEST_F(AsyncModeTest, ToggleAsyncMode) {
+    EXPECT_FALSE(Logger::getInstance().isAsync());
+    Logger::getInstance().setAsync(true);
+    EXPECT_TRUE(Logger::getInstance().isAsync());
+    Logger::getInstance().setAsync(false);
+    EXPECT_FALSE(Logger::getInstance().isAsync());
+}
+
+// Test 2: Records are written by the backend after drain()
+TEST_F(AsyncModeTest, DrainWritesAllRecords) {
+    test_utils::TempFile temp_base("async_drain.log");
+    Logger::getInstance().setFile(true, temp_base.string());
+    Logger::getInstance().setAsync(true);
+
+    for (int i = 0; i < 1000; ++i) {
+        Logger::info() << "async message " << i;
+    }
+    Logger::getInstance().drain();
+
+    std::string content = read_logs("async_drain");
+    EXPECT_EQ(count_lines(content), 1000u);
+    EXPECT_NE(content.find("async message 0"), std::string::npos);
+    EXPECT_NE(content.find("async message 999"), std::string::npos);
+}
+
+// Test 3: Per-thread ordering is preserved and nothing is lost across threads
+TEST_F(AsyncModeTest, MultiThreadNoLoss) {
+    test_utils::TempFile temp_base("async_multi.log");
+    Logger::getInstance().setFile(true, temp_base.string());
+    // Small rings force producers to wait on the backend
+    Logger::getInstance().setAsync(true, 4096);
+
+    const int num_threads = 8;
+    const int logs_per_thread = 2000;
+    std::vector<std::thread> threads;
+    for (int i = 0; i < num_threads; ++i) {
+        threads.emplace_back([i, logs_per_thread]() {
+            for (int j = 0; j < logs_per_thread; ++j) {
+                Logger::info() << "T" << i << " #" << j;
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    Logger::getInstance().drain();
+
+    std::string content = read_logs("async_multi");
+    EXPECT_EQ(count_lines(content), static_cast<size_t>(num_threads * logs_per_thread));
+
+    // Records from one thread appear in submission order
+    size_t last = 0;
+    for (int j = 0; j < logs_per_thread; j += 500) {
+        std::string needle = "T3 #" + std::to_string(j) + "\n";
+        size_t pos = content.find(needle);
+        ASSERT_NE(pos, std::string::npos);
+        EXPECT_GE(pos, last);
+        last = pos;
+    }
+}
+
+// Test 4: Disabling async mode flushes pending records
+TEST_F(AsyncModeTest, DisableFlushesPending) {
+    test_utils::TempFile temp_base("async_disable.log");
+    Logger::getInstance().setFile(true, temp_base.string());
+    Logger::getInstance().setAsync(true);
+
+    for (int i = 0; i < 100; ++i) {
+        Logger::warning() << "pending " << i;
+    }
+    Logger::getInstance().setAsync(false);
+
+    EXPECT_EQ(count_lines(read_logs("async_disable")), 100u);
+}
+
+// Test 5: Oversized records fall back to synchronous output
+TEST_F(AsyncModeTest, OversizedRecordFallback) {
+    test_utils::TempFile temp_base("async_long.log");
+    Logger::getInstance().setFile(true, temp_base.string());
+    Logger::getInstance().setAsync(true, 1024);
+
+    std::string long_message(10000, 'B');
+    Logger::getInstance().log(LogLevel::INFO, long_message.c_str(), __FILE__, __LINE__);
+    Logger::getInstance().drain();
+
+    EXPECT_NE(read_logs("async_long").find(long_message), std::string::npos);
+}
+
+// Test 6: Filtered records never reach the ring
+TEST_F(AsyncModeTest, LevelFilteringInAsyncMode) {
+    test_utils::TempFile temp_base("async_filter.log");
+    Logger::getInstance().setFile(true, temp_base.string());
+    Logger::getInstance().setLevel(LogLevel::WARNING);
+    Logger::getInstance().setAsync(true);
+
+    Logger::info() << "filtered info";
+    Logger::error() << "kept error";
+    Logger::getInstance().drain();
+
+    std::string content = read_logs("async_filter");
+    EXPECT_EQ(content.find("filtered info"), std::string::npos);
+    EXPECT_NE(content.find("kept error"), std::string::npos);
+}
+
+// Test 7: Bounded queue with Block policy never loses records
+TEST_F(AsyncModeTest, BoundedQueueBlockNoLoss) {
+    test_utils::TempFile temp_base("async_bounded_block.log");
+    Logger::getInstance().setFile(true, temp_base.string());
+    Logger::getInstance().setBoundedQueue(true, 8, OverflowPolicy::Block);
+    EXPECT_TRUE(Logger::getInstance().isAsync());
+
+    const uint64_t dropped_before = Logger::getInstance().droppedCount();
+    const int num_threads = 4;
+    const int logs_per_thread = 1000;
+    std::vector<std::thread> threads;
+    for (int i = 0; i < num_threads; ++i) {
+        threads.emplace_back([i, logs_per_thread]() {
+            for (int j = 0; j < logs_per_thread; ++j) {
+                Logger::info() << "B" << i << " #" << j;
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    Logger::getInstance().drain();
+
+    EXPECT_EQ(Logger::getInstance().droppedCount(), dropped_before);
+    EXPECT_EQ(count_lines(read_logs("async_bounded_block")),
+              static_cast<size_t>(num_threads * logs_per_thread));
+}
+
+// Test 8: Drop policies account for every record and report drops
+TEST_F(AsyncModeTest, BoundedQueueDropAccounting) {
+    for (OverflowPolicy policy : {OverflowPolicy::DropNewest, OverflowPolicy::DropOldest}) {
+        test_utils::TempFile temp_base("async_bounded_drop.log");
+        Logger::getInstance().setFile(true, temp_base.string());
+        Logger::getInstance().setBoundedQueue(true, 4, policy);
+
+        const uint64_t dropped_before = Logger::getInstance().droppedCount(LogLevel::INFO);
+        const int num_logs = 20000;
+        for (int i = 0; i < num_logs; ++i) {
+            Logger::info() << "drop test " << i;
+        }
+        Logger::getInstance().setBoundedQueue(false);
+        const uint64_t dropped = Logger::getInstance().droppedCount(LogLevel::INFO) - dropped_before;
+
+        std::string content = read_logs("async_bounded_drop");
+        size_t written = 0;
+        for (size_t pos = content.find("drop test "); pos != std::string::npos;
+             pos = content.find("drop test ", pos + 1)) {
+            ++written;
+        }
+        EXPECT_EQ(written + dropped, static_cast<size_t>(num_logs));
+        if (dropped > 0) {
+            EXPECT_NE(content.find(" records dropped (DEBUG="), std::string::npos)
+                << "Drop summary should be reported";
+        }
+
+        Logger::getInstance().setFile(false, "");
+        cleanup_temp_logs();
+    }
+}
+
+// Test 9: DropBelowLevel never drops records at or above the threshold
+TEST_F(AsyncModeTest, BoundedQueueDropBelowLevel) {
+    test_utils::TempFile temp_base("async_bounded_level.log");
+    Logger::getInstance().setFile(true, temp_base.string());
+    Logger::getInstance().setBoundedQueue(true, 4, OverflowPolicy::DropBelowLevel, LogLevel::ERROR);
+
+    const uint64_t errors_dropped_before = Logger::getInstance().droppedCount(LogLevel::ERROR);
+    const int num_logs = 5000;
+    for (int i = 0; i < num_logs; ++i) {
+        Logger::debug() << "low " << i;
+        Logger::error() << "high " << i;
+    }
+    Logger::getInstance().drain();
+
+    EXPECT_EQ(Logger::getInstance().droppedCount(LogLevel::ERROR), errors_dropped_before);
+    std::string content = read_logs("async_bounded_level");
+    EXPECT_NE(content.find("high 0\n"), std::string::npos);
+    EXPECT_NE(content.find("high " + std::to_string(num_logs - 1) + "\n"), std::string::npos);
+}
+
+// Test 10: Switching between ring and bounded modes
+TEST_F(AsyncModeTest, SwitchBetweenAsyncModes) {
+    test_utils::TempFile temp_base("async_switch.log");
+    Logger::getInstance().setFile(true, temp_base.string());
+
+    Logger::getInstance().setAsync(true);
+    Logger::info() << "from ring";
+    Logger::getInstance().setBoundedQueue(true);
+    Logger::info() << "from queue";
+    Logger::getInstance().setAsync(true);
+    Logger::getInstance().drain();
+
+    std::string content = read_logs("async_switch");
+    EXPECT_NE(content.find("from ring"), std::string::npos);
+    EXPECT_NE(content.find("from queue"), std::string::npos);
+}
+
+// Test 11: Sequence numbers are unique, gap-free and ordered per thread
+TEST_F(AsyncModeTest, SequenceNumbersAcrossThreads) {
+    test_utils::TempFile temp_base("async_sequence.log");
+    Logger::getInstance().setFile(true, temp_base.string());
+    Logger::getInstance().setSequenceNumbers(true);
+    Logger::getInstance().setAsync(true);
+
+    const int num_threads = 4;
+    const int logs_per_thread = 2000;
+    std::vector<std::thread> threads;
+    for (int i = 0; i < num_threads; ++i) {
+        threads.emplace_back([i, logs_per_thread]() {
+            for (int j = 0; j < logs_per_thread; ++j) {
+                Logger::info() << "S" << i << " " << j;
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    Logger::getInstance().drain();
+    Logger::getInstance().setSequenceNumbers(false);
+
+    // Each line: "YYYY-MM-DD HH:MM:SS #N [INFO] file:line - S<thread> <j>"
+    std::istringstream content(read_logs("async_sequence"));
+    std::vector<uint64_t> sequences;
+    std::vector<uint64_t> last_per_thread(num_threads, 0);
+    std::string line;
+    while (std::getline(content, line)) {
+        size_t hash = line.find(" #");
+        ASSERT_NE(hash, std::string::npos) << line;
+        uint64_t seq = std::stoull(line.substr(hash + 2));
+        int thread = std::stoi(line.substr(line.rfind(" - S") + 4));
+        EXPECT_GT(seq, last_per_thread[thread]) << line;
+        last_per_thread[thread] = seq;
+        sequences.push_back(seq);
+    }
+
+    ASSERT_EQ(sequences.size(), static_cast<size_t>(num_threads * logs_per_thread));
+    std::sort(sequences.begin(), sequences.end());
+    for (size_t i = 1; i < sequences.size(); ++i) {
+        EXPECT_EQ(sequences[i], sequences[i - 1] + 1) << "Gap after #" << sequences[i - 1];
+    }
+}
+
+// Test 12: An idle backend parks and is woken by the next record
+TEST_F(AsyncModeTest, IdleBackendWakesOnRecord) {
+    test_utils::TempFile temp_base("async_idle.log");
+    Logger::getInstance().setFile(true, temp_base.string());
+    Logger::getInstance().setAsync(true);
+
+    for (int round = 0; round < 3; ++round) {
+        // Long enough for the backend to back off to its longest wait
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        Logger::info() << "after idle " << round;
+
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+        const std::string expected = "after idle " + std::to_string(round) + "\n";
+        while (read_logs("async_idle").find(expected) == std::string::npos &&
+               std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        EXPECT_NE(read_logs("async_idle").find(expected), std::string::npos);
+    }
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    Logger::info() << "before drain";
+    Logger::getInstance().drain();
+    EXPECT_NE(read_logs("async_idle").find("before drain\n"), std::string::npos);
+}
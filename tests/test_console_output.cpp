@@ -132,3 +132,84 @@ TEST_F(ConsoleOutputTest, ColorCodesPresent) {
     EXPECT_TRUE(content.find("\033[31m") != std::string::npos ||
                 content.find("\033[")) << "Expected ANSI color codes";
 }
+
+// Test 7: Console and file share the same rendered line (colors only wrap the level)
+TEST_F(ConsoleOutputTest, ConsoleMatchesFileLine) {
+    test_utils::TempFile temp_output("console_shared.txt");
+    test_utils::TempFile temp_base("console_shared_file.log");
+    Logger::getInstance().setFile(true, temp_base.string());
+
+    FILE* original_stdout = stdout;
+    stdout = fopen(temp_output.string().c_str(), "w");
+    ASSERT_NE(stdout, nullptr);
+
+    Logger::getInstance().log(LogLevel::WARNING, "shared line", "test.cpp", 7);
+
+    fclose(stdout);
+    stdout = original_stdout;
+    Logger::getInstance().setFile(false, "");
+
+    std::string console = temp_output.read_content();
+    EXPECT_NE(console.find("[\033[33mWARNING\033[0m]"), std::string::npos) << console;
+
+    std::string file_content;
+    auto temp_dir = std::filesystem::temp_directory_path();
+    for (const auto& entry : std::filesystem::directory_iterator(temp_dir)) {
+        if (entry.path().filename().string().find("console_shared_file") == 0) {
+            std::ifstream file(entry.path());
+            std::stringstream buffer;
+            buffer << file.rdbuf();
+            file_content = buffer.str();
+            std::filesystem::remove(entry.path());
+        }
+    }
+
+    EXPECT_EQ(stripAnsiCodes(console), file_content);
+}
+
+// Test 8: Repeated hits of one call site reuse its cached prefix, with and without color
+TEST_F(ConsoleOutputTest, CachedSitePrefix) {
+    test_utils::TempFile temp_output("console_prefix.txt");
+    test_utils::TempFile temp_base("console_prefix_file.log");
+    Logger::getInstance().setFile(true, temp_base.string());
+
+    FILE* original_stdout = stdout;
+    stdout = fopen(temp_output.string().c_str(), "w");
+    ASSERT_NE(stdout, nullptr);
+
+    const LogSite* site = nullptr;
+    int site_line = 0;
+    for (int i = 0; i < 3; ++i) {
+        site_line = __LINE__; site = &LOGGER_SITE(LogLevel::WARNING, nullptr);
+        LogStream(*site) << "cached " << i;
+    }
+
+    fclose(stdout);
+    stdout = original_stdout;
+    Logger::getInstance().setFile(false, "");
+
+    ASSERT_NE(site->prefix, nullptr);
+    ASSERT_TRUE(site->prefix->ready());
+    const std::string expected = " [WARNING] test_console_output.cpp:" + std::to_string(site_line) + " - ";
+    EXPECT_EQ(site->prefix->plain(), expected);
+    EXPECT_EQ(site->prefix->colored(),
+              " [\033[33mWARNING\033[0m] test_console_output.cpp:" + std::to_string(site_line) + " - ");
+
+    std::string console = temp_output.read_content();
+    EXPECT_NE(console.find("[\033[33mWARNING\033[0m] test_console_output.cpp:"), std::string::npos) << console;
+    EXPECT_NE(console.find(expected.substr(11) + "cached 2\n"), std::string::npos) << console;
+
+    std::string file_content;
+    auto temp_dir = std::filesystem::temp_directory_path();
+    for (const auto& entry : std::filesystem::directory_iterator(temp_dir)) {
+        if (entry.path().filename().string().find("console_prefix_file") == 0) {
+            std::ifstream file(entry.path());
+            std::stringstream buffer;
+            buffer << file.rdbuf();
+            file_content = buffer.str();
+            std::filesystem::remove(entry.path());
+        }
+    }
+    EXPECT_EQ(std::count(file_content.begin(), file_content.end(), '\n'), 3);
+    EXPECT_EQ(stripAnsiCodes(console), file_content);
+}
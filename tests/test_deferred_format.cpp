@@ -0,0 +1,145 @@
+#include <gtest/gtest.h>
+#include "Logger.hpp"
+#include "test_utils/test_helpers.hpp"
+#include <thread>
+#include <vector>
+#include <sstream>
+#include <limits>
+#include <functional>
+
+class DeferredFormatTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        Logger::getInstance().setLevel(LogLevel::DEBUG);
+        Logger::getInstance().setConsole(false);
+    }
+
+    void TearDown() override {
+        Logger::getInstance().setAsync(false);
+        Logger::getInstance().setDeferredFormat(false);
+        Logger::getInstance().setFile(false, "");
+        Logger::getInstance().setConsole(true);
+    }
+
+    // Run log_func with file output enabled and return the file content
+    std::string capture_log(const std::string& base_name, std::function<void()> log_func) {
+        test_utils::TempFile temp_base(base_name + ".log");
+        Logger::getInstance().setFile(true, temp_base.string());
+
+        log_func();
+        Logger::getInstance().drain();
+        Logger::getInstance().setFile(false, "");
+
+        std::string content;
+        auto temp_dir = std::filesystem::temp_directory_path();
+        for (const auto& entry : std::filesystem::directory_iterator(temp_dir)) {
+            if (entry.path().filename().string().find(base_name) == 0) {
+                std::ifstream file(entry.path());
+                std::stringstream buffer;
+                buffer << file.rdbuf();
+                content += buffer.str();
+                file.close();
+                std::filesystem::remove(entry.path());
+            }
+        }
+        return content;
+    }
+
+    // Extract message parts (after " - ") from log content
+    std::vector<std::string> messages(const std::string& content) {
+        std::vector<std::string> result;
+        std::istringstream in(content);
+        std::string line;
+        while (std::getline(in, line)) {
+            size_t pos = line.find(" - ");
+            if (pos != std::string::npos) result.push_back(line.substr(pos + 3));
+        }
+        return result;
+    }
+
+    static void log_all_types() {
+        int value = 42;
+        Logger::info() << "int " << -12345 << " uint " << 4000000000u
+                       << " ll " << std::numeric_limits<long long>::min();
+        Logger::info() << "double " << 3.14159 << " float " << -2.5f << " big " << 1e300;
+        Logger::info() << "bool " << true << " " << false << " char " << 'A' << 'z';
+        Logger::info() << "ptr " << static_cast<const void*>(&value);
+        Logger::info() << std::string("std::string ") << "and " << "literal";
+        Logger::fatal() << "fatal " << 7;
+        log_warning("func ", 1, ' ', 2.5, ' ', true);
+    }
+};
+
+// Test 1: Deferred output is identical to eager formatting
+TEST_F(DeferredFormatTest, MatchesEagerFormatting) {
+    auto eager = messages(capture_log("deferred_eager", log_all_types));
+
+    Logger::getInstance().setDeferredFormat(true);
+    EXPECT_TRUE(Logger::getInstance().isDeferredFormat());
+    auto deferred = messages(capture_log("deferred_sync", log_all_types));
+
+    ASSERT_EQ(eager.size(), 7u);
+    EXPECT_EQ(eager, deferred);
+}
+
+// Test 2: Deferred formatting combined with async backend
+TEST_F(DeferredFormatTest, AsyncDeferredMatchesEager) {
+    auto eager = messages(capture_log("deferred_eager_async", log_all_types));
+
+    Logger::getInstance().setDeferredFormat(true);
+    Logger::getInstance().setAsync(true);
+    auto deferred = messages(capture_log("deferred_async", log_all_types));
+
+    EXPECT_EQ(eager, deferred);
+}
+
+// Test 3: Bounded queue carries encoded records as well
+TEST_F(DeferredFormatTest, BoundedQueueDeferred) {
+    Logger::getInstance().setDeferredFormat(true);
+    Logger::getInstance().setBoundedQueue(true, 64, OverflowPolicy::Block);
+
+    auto content = capture_log("deferred_bounded", []() {
+        for (int i = 0; i < 100; ++i) {
+            Logger::info() << "value " << i << " ratio " << i * 0.5;
+        }
+    });
+    Logger::getInstance().setBoundedQueue(false);
+
+    EXPECT_NE(content.find("value 0 ratio 0.0000"), std::string::npos);
+    EXPECT_NE(content.find("value 99 ratio 49.5000"), std::string::npos);
+}
+
+// Test 4: Long strings are truncated to the stream buffer, never overflow
+TEST_F(DeferredFormatTest, LongStringTruncated) {
+    Logger::getInstance().setDeferredFormat(true);
+
+    std::string long_str(10000, 'Q');
+    auto content = capture_log("deferred_long", [&]() {
+        Logger::info() << long_str << " tail " << 1;
+    });
+
+    auto lines = messages(content);
+    ASSERT_EQ(lines.size(), 1u);
+    EXPECT_GT(lines[0].size(), 4000u);
+    EXPECT_LT(lines[0].size(), 4096u);
+}
+
+// Test 5: The {} format API writes one encoded string argument; output matches eager mode
+TEST_F(DeferredFormatTest, FormatApiMatchesEager) {
+    auto log_formatted = []() {
+        Logger::infof("order {} filled at {:.4f}", 42, 101.256);
+        Logger::infof("{:>8}|{:x}|{}", std::string("name"), 255u, true);
+        Logger::fatalf("fatal {}", 7);
+        Logger::info() << "mixed " << 1;
+        LOG_INFOF("macro {:.1f}", 2.25);
+    };
+    auto eager = messages(capture_log("deferred_fmt_eager", log_formatted));
+
+    Logger::getInstance().setDeferredFormat(true);
+    auto deferred = messages(capture_log("deferred_fmt_sync", log_formatted));
+
+    ASSERT_EQ(eager.size(), 5u);
+    EXPECT_EQ(eager[0], "order 42 filled at 101.2560");
+    EXPECT_EQ(eager[2], "FATAL ERROR: fatal 7");
+    EXPECT_EQ(eager, deferred);
+}
@@ -4,6 +4,14 @@
 #include <thread>
 #include <regex>
 #include <sstream>
+#include <algorithm>
+#include <iomanip>
+#ifndef _WIN32
+#include <sys/resource.h>
+#include <csignal>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
 
 class FileOutputTest : public ::testing::Test {
 protected:
@@ -293,3 +301,1046 @@ TEST_F(FileOutputTest, ReopenFile) {
         std::filesystem::remove(f);
     }
 }
+
+// Test 11: Group commit keeps records buffered until a commit point
+TEST_F(FileOutputTest, GroupCommitBatchesRecords) {
+    test_utils::TempFile temp_base("test_group_commit.log");
+
+    FileCommitPolicy policy;
+    policy.flushBytes = 1 << 20;
+    policy.flushOnError = false;
+    Logger::getInstance().setFileCommitPolicy(policy);
+    Logger::getInstance().setFile(true, temp_base.string());
+
+    Logger::getInstance().log(LogLevel::INFO, "batched record", __FILE__, __LINE__);
+
+    auto found_files = findFilesWithPattern("test_group_commit.log");
+    ASSERT_FALSE(found_files.empty());
+    EXPECT_EQ(readFileContent(found_files[0]).find("batched record"), std::string::npos)
+        << "Record should stay buffered below the byte threshold";
+
+    Logger::getInstance().drain();
+    EXPECT_NE(readFileContent(found_files[0]).find("batched record"), std::string::npos)
+        << "drain() should commit buffered records";
+
+    Logger::getInstance().setFileCommitPolicy(FileCommitPolicy{});
+    for (const auto& f : found_files) {
+        std::filesystem::remove(f);
+    }
+}
+
+// Test 12: ERROR records force an immediate commit
+TEST_F(FileOutputTest, GroupCommitFlushOnError) {
+    test_utils::TempFile temp_base("test_commit_error.log");
+
+    FileCommitPolicy policy;
+    policy.flushBytes = 1 << 20;
+    policy.flushOnError = true;
+    Logger::getInstance().setFileCommitPolicy(policy);
+    Logger::getInstance().setFile(true, temp_base.string());
+
+    Logger::getInstance().log(LogLevel::INFO, "before error", __FILE__, __LINE__);
+    Logger::getInstance().log(LogLevel::ERROR, "error record", __FILE__, __LINE__);
+
+    auto found_files = findFilesWithPattern("test_commit_error.log");
+    ASSERT_FALSE(found_files.empty());
+    std::string content = readFileContent(found_files[0]);
+    EXPECT_NE(content.find("before error"), std::string::npos);
+    EXPECT_NE(content.find("error record"), std::string::npos);
+
+    Logger::getInstance().setFileCommitPolicy(FileCommitPolicy{});
+    for (const auto& f : found_files) {
+        std::filesystem::remove(f);
+    }
+}
+
+// Test 13: Byte threshold and fdatasync durability
+TEST_F(FileOutputTest, GroupCommitByteThresholdWithFdatasync) {
+    test_utils::TempFile temp_base("test_commit_sync.log");
+
+    FileCommitPolicy policy;
+    policy.flushBytes = 8192;
+    policy.durability = FileDurability::Fdatasync;
+    Logger::getInstance().setFileCommitPolicy(policy);
+    Logger::getInstance().setFile(true, temp_base.string());
+
+    for (int i = 0; i < 1000; ++i) {
+        Logger::info() << "threshold record " << i;
+    }
+
+    auto found_files = findFilesWithPattern("test_commit_sync.log");
+    ASSERT_FALSE(found_files.empty());
+    // At least one batch crossed the threshold and was committed
+    EXPECT_GE(std::filesystem::file_size(found_files[0]), 8192u);
+
+    Logger::getInstance().setFile(false, "");
+    EXPECT_NE(readFileContent(found_files[0]).find("threshold record 999"), std::string::npos)
+        << "Closing the file should commit the final batch";
+
+    Logger::getInstance().setFileCommitPolicy(FileCommitPolicy{});
+    for (const auto& f : found_files) {
+        std::filesystem::remove(f);
+    }
+}
+
+// Test 14: Double-buffered backend writes every record with the usual path rules
+TEST_F(FileOutputTest, DoubleBufferedBackend) {
+    test_utils::TempFile temp_base("test_double_buffer.log");
+
+    Logger::getInstance().setFileBackend(FileBackend::DoubleBuffered, 64 * 1024);
+    EXPECT_EQ(Logger::getInstance().getFileBackend(), FileBackend::DoubleBuffered);
+    Logger::getInstance().setFile(true, temp_base.string());
+
+    const int num_threads = 4;
+    const int logs_per_thread = 5000;
+    std::vector<std::thread> threads;
+    for (int i = 0; i < num_threads; ++i) {
+        threads.emplace_back([i, logs_per_thread]() {
+            for (int j = 0; j < logs_per_thread; ++j) {
+                Logger::info() << "double buffer " << i << " " << j;
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    Logger::getInstance().drain();
+
+    auto found_files = findFilesWithPattern("test_double_buffer.log");
+    ASSERT_EQ(found_files.size(), 1u);
+    EXPECT_TRUE(std::regex_search(found_files[0], std::regex(R"(-\d{8}\.log$)")));
+
+    std::ifstream file(found_files[0]);
+    std::string line;
+    size_t line_count = 0;
+    while (std::getline(file, line)) {
+        if (!line.empty()) ++line_count;
+    }
+    EXPECT_EQ(line_count, static_cast<size_t>(num_threads * logs_per_thread));
+
+    Logger::getInstance().setFile(false, "");
+    Logger::getInstance().setFileBackend(FileBackend::Stdio);
+    for (const auto& f : found_files) {
+        std::filesystem::remove(f);
+    }
+}
+
+// Test 15: Switching backends while the file is open keeps earlier records
+TEST_F(FileOutputTest, SwitchFileBackendWhileOpen) {
+    test_utils::TempFile temp_base("test_backend_switch.log");
+
+    Logger::getInstance().setFile(true, temp_base.string());
+    Logger::getInstance().log(LogLevel::INFO, "stdio record", __FILE__, __LINE__);
+
+    Logger::getInstance().setFileBackend(FileBackend::DoubleBuffered);
+    Logger::getInstance().log(LogLevel::ERROR, "buffered record", __FILE__, __LINE__);
+
+    Logger::getInstance().setFileBackend(FileBackend::Stdio);
+    Logger::getInstance().log(LogLevel::INFO, "stdio again", __FILE__, __LINE__);
+
+    auto found_files = findFilesWithPattern("test_backend_switch.log");
+    ASSERT_FALSE(found_files.empty());
+    std::string content = readFileContent(found_files[0]);
+    EXPECT_NE(content.find("stdio record"), std::string::npos);
+    EXPECT_NE(content.find("buffered record"), std::string::npos);
+    EXPECT_NE(content.find("stdio again"), std::string::npos);
+    EXPECT_LT(content.find("stdio record"), content.find("buffered record"));
+    EXPECT_LT(content.find("buffered record"), content.find("stdio again"));
+
+    for (const auto& f : found_files) {
+        std::filesystem::remove(f);
+    }
+}
+
+// Test 16: io_uring backend (falls back to plain writes when unavailable)
+TEST_F(FileOutputTest, IoUringBackend) {
+    test_utils::TempFile temp_base("test_io_uring.log");
+
+    FileCommitPolicy policy;
+    policy.durability = FileDurability::Fdatasync;
+    Logger::getInstance().setFileCommitPolicy(policy);
+    Logger::getInstance().setFileBackend(FileBackend::IoUring, 16 * 1024);
+    Logger::getInstance().setFile(true, temp_base.string());
+    Logger::getInstance().log(LogLevel::INFO, "first session", __FILE__, __LINE__);
+    Logger::getInstance().setFile(false, "");
+
+    // Reopening appends after the existing content
+    Logger::getInstance().setFile(true, temp_base.string());
+    const int num_threads = 4;
+    const int logs_per_thread = 5000;
+    std::vector<std::thread> threads;
+    for (int i = 0; i < num_threads; ++i) {
+        threads.emplace_back([i, logs_per_thread]() {
+            for (int j = 0; j < logs_per_thread; ++j) {
+                Logger::info() << "io_uring " << i << " " << j;
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    Logger::getInstance().drain();
+
+    auto found_files = findFilesWithPattern("test_io_uring.log");
+    ASSERT_EQ(found_files.size(), 1u);
+    std::string content = readFileContent(found_files[0]);
+    EXPECT_EQ(content.find("first session"), content.find(" - ") + 3) << "Earlier content must be kept";
+    EXPECT_EQ(static_cast<size_t>(std::count(content.begin(), content.end(), '\n')),
+              static_cast<size_t>(num_threads * logs_per_thread + 1));
+
+    Logger::getInstance().setFile(false, "");
+    Logger::getInstance().setFileBackend(FileBackend::Stdio);
+    Logger::getInstance().setFileCommitPolicy(FileCommitPolicy{});
+    for (const auto& f : found_files) {
+        std::filesystem::remove(f);
+    }
+}
+
+// Test 17: mmap backend rolls over segments and trims the file at close
+TEST_F(FileOutputTest, MmapBackendSegments) {
+    test_utils::TempFile temp_base("test_mmap.log");
+
+    // Small segments force many rollovers
+    Logger::getInstance().setFileBackend(FileBackend::Mmap, 8192);
+    Logger::getInstance().setFile(true, temp_base.string());
+    Logger::getInstance().log(LogLevel::INFO, "first session", __FILE__, __LINE__);
+    Logger::getInstance().setFile(false, "");
+
+    Logger::getInstance().setFile(true, temp_base.string());
+    const int num_threads = 4;
+    const int logs_per_thread = 5000;
+    std::vector<std::thread> threads;
+    for (int i = 0; i < num_threads; ++i) {
+        threads.emplace_back([i, logs_per_thread]() {
+            for (int j = 0; j < logs_per_thread; ++j) {
+                Logger::info() << "mmap " << i << " " << j;
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    Logger::getInstance().setFile(false, "");
+    Logger::getInstance().setFileBackend(FileBackend::Stdio);
+
+    auto found_files = findFilesWithPattern("test_mmap.log");
+    ASSERT_EQ(found_files.size(), 1u);
+    std::string content = readFileContent(found_files[0]);
+    EXPECT_EQ(content.find('\0'), std::string::npos) << "File must be truncated to its real length";
+    EXPECT_EQ(content.back(), '\n');
+    EXPECT_NE(content.find("first session"), std::string::npos);
+    EXPECT_EQ(static_cast<size_t>(std::count(content.begin(), content.end(), '\n')),
+              static_cast<size_t>(num_threads * logs_per_thread + 1));
+
+    for (const auto& f : found_files) {
+        std::filesystem::remove(f);
+    }
+}
+
+#ifdef LOGGER_HAS_MMAP
+// Test 18: Concurrent writers reserve disjoint ranges without a lock
+TEST_F(FileOutputTest, MmapWriterConcurrentReservations) {
+    test_utils::TempFile temp_file("test_mmap_writer.log");
+
+    MmapFileWriter writer(4096);
+    ASSERT_TRUE(writer.open(temp_file.string(), FileCommitPolicy{}));
+
+    const int num_threads = 8;
+    const int writes_per_thread = 2000;
+    std::vector<std::thread> threads;
+    for (int i = 0; i < num_threads; ++i) {
+        threads.emplace_back([&writer, i, writes_per_thread]() {
+            // Fixed-size records make corruption easy to detect
+            std::string record = "writer-" + std::to_string(i) + "-payload\n";
+            for (int j = 0; j < writes_per_thread; ++j) {
+                writer.write(record.data(), record.size());
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    writer.commit(FileDurability::Fdatasync);
+    writer.close();
+
+    auto lines = temp_file.read_lines();
+    ASSERT_EQ(lines.size(), static_cast<size_t>(num_threads * writes_per_thread));
+    std::vector<int> counts(num_threads, 0);
+    for (const auto& line : lines) {
+        ASSERT_EQ(line.size(), std::string("writer-0-payload").size()) << line;
+        counts[line[7] - '0']++;
+    }
+    for (int c : counts) {
+        EXPECT_EQ(c, writes_per_thread);
+    }
+}
+#endif
+
+// Test 19: O_DIRECT backend handles unaligned tails at commit and close
+TEST_F(FileOutputTest, DirectBackendPartialBlocks) {
+    test_utils::TempFile temp_base("test_direct.log");
+
+    Logger::getInstance().setFileBackend(FileBackend::Direct, 64 * 1024);
+    Logger::getInstance().setFile(true, temp_base.string());
+    Logger::getInstance().log(LogLevel::INFO, "first session", __FILE__, __LINE__);
+    Logger::getInstance().drain();
+
+    auto found_files = findFilesWithPattern("test_direct.log");
+    ASSERT_EQ(found_files.size(), 1u);
+    // After a commit the partial block is on disk and the file has its real length
+    std::string content = readFileContent(found_files[0]);
+    EXPECT_EQ(content.find('\0'), std::string::npos);
+    EXPECT_NE(content.find("first session"), std::string::npos);
+    Logger::getInstance().setFile(false, "");
+
+    // Reopen: the unaligned tail of the existing file is rewritten together with new data
+    Logger::getInstance().setFile(true, temp_base.string());
+    const int num_threads = 4;
+    const int logs_per_thread = 5000;
+    std::vector<std::thread> threads;
+    for (int i = 0; i < num_threads; ++i) {
+        threads.emplace_back([i, logs_per_thread]() {
+            for (int j = 0; j < logs_per_thread; ++j) {
+                Logger::info() << "direct " << i << " " << j;
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    Logger::getInstance().setFile(false, "");
+    Logger::getInstance().setFileBackend(FileBackend::Stdio);
+
+    content = readFileContent(found_files[0]);
+    EXPECT_EQ(content.find('\0'), std::string::npos) << "File must be trimmed to its real length";
+    EXPECT_EQ(content.find("first session"), content.find(" - ") + 3);
+    EXPECT_EQ(static_cast<size_t>(std::count(content.begin(), content.end(), '\n')),
+              static_cast<size_t>(num_threads * logs_per_thread + 1));
+
+    for (const auto& f : found_files) {
+        std::filesystem::remove(f);
+    }
+}
+
+// Test 20: Sub-second timestamp precision
+TEST_F(FileOutputTest, TimestampPrecision) {
+    test_utils::TempFile temp_base("test_precision.log");
+    Logger::getInstance().setFile(true, temp_base.string());
+
+    const std::pair<TimePrecision, const char*> cases[] = {
+        {TimePrecision::Seconds, R"(^\d{4}-\d{2}-\d{2} \d{2}:\d{2}:\d{2} \[INFO\] .* - precision 0$)"},
+        {TimePrecision::Milliseconds, R"(^\d{4}-\d{2}-\d{2} \d{2}:\d{2}:\d{2}\.\d{3} \[INFO\] .* - precision 1$)"},
+        {TimePrecision::Microseconds, R"(^\d{4}-\d{2}-\d{2} \d{2}:\d{2}:\d{2}\.\d{6} \[INFO\] .* - precision 2$)"},
+        {TimePrecision::Nanoseconds, R"(^\d{4}-\d{2}-\d{2} \d{2}:\d{2}:\d{2}\.\d{9} \[INFO\] .* - precision 3$)"},
+    };
+    for (const auto& [precision, pattern] : cases) {
+        Logger::getInstance().setTimePrecision(precision);
+        Logger::info() << "precision " << static_cast<int>(precision);
+    }
+    Logger::getInstance().setTimePrecision(TimePrecision::Seconds);
+    Logger::getInstance().setFile(false, "");
+
+    auto found_files = findFilesWithPattern("test_precision.log");
+    ASSERT_EQ(found_files.size(), 1u);
+    std::istringstream content(readFileContent(found_files[0]));
+    std::string line;
+    for (const auto& [precision, pattern] : cases) {
+        ASSERT_TRUE(std::getline(content, line));
+        EXPECT_TRUE(std::regex_match(line, std::regex(pattern))) << line;
+    }
+
+    for (const auto& f : found_files) {
+        std::filesystem::remove(f);
+    }
+}
+
+// Test 21: TSC call-site timestamps convert to wall-clock time in order
+TEST_F(FileOutputTest, TscClockSourceMatchesWallClock) {
+    test_utils::TempFile temp_base("test_tsc.log");
+    Logger::getInstance().setFile(true, temp_base.string());
+    Logger::getInstance().setTimePrecision(TimePrecision::Nanoseconds);
+    Logger::getInstance().setClockSource(ClockSource::Tsc);
+    EXPECT_EQ(Logger::getInstance().getClockSource(), ClockSource::Tsc);
+
+    const auto before = std::chrono::system_clock::now();
+    for (int i = 0; i < 1000; ++i) {
+        Logger::info() << "tsc " << i;
+    }
+    const auto after = std::chrono::system_clock::now();
+
+    Logger::getInstance().setClockSource(ClockSource::Realtime);
+    Logger::getInstance().setTimePrecision(TimePrecision::Seconds);
+    Logger::getInstance().setFile(false, "");
+
+    auto found_files = findFilesWithPattern("test_tsc.log");
+    ASSERT_EQ(found_files.size(), 1u);
+    std::istringstream content(readFileContent(found_files[0]));
+
+    // Parse "YYYY-MM-DD HH:MM:SS.nnnnnnnnn" into nanoseconds since the epoch
+    auto parse = [](const std::string& line) {
+        std::tm tm{};
+        std::istringstream in(line.substr(0, 19));
+        in >> std::get_time(&tm, "%Y-%m-%d %H:%M:%S");
+        tm.tm_isdst = -1;
+        return static_cast<int64_t>(std::mktime(&tm)) * 1000000000 + std::stoll(line.substr(20, 9));
+    };
+    auto to_ns = [](std::chrono::system_clock::time_point t) {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(t.time_since_epoch()).count();
+    };
+
+    std::string line;
+    int64_t previous = 0;
+    int count = 0;
+    while (std::getline(content, line)) {
+        int64_t stamp = parse(line);
+        EXPECT_GE(stamp, previous) << line;
+        // Allow for the calibration error of the conversion
+        EXPECT_GT(stamp, to_ns(before) - 50000000) << line;
+        EXPECT_LT(stamp, to_ns(after) + 50000000) << line;
+        previous = stamp;
+        ++count;
+    }
+    EXPECT_EQ(count, 1000);
+
+    for (const auto& f : found_files) {
+        std::filesystem::remove(f);
+    }
+}
+
+// Test 22: Daily rotation switches to the pre-opened file at local midnight
+TEST_F(FileOutputTest, DailyRotationAtMidnight) {
+    test_utils::TempFile temp_base("test_rotate_daily.log");
+    // A lead longer than a day makes the rotator open tomorrow's file right away
+    Logger::getInstance().setFileRotation(FileRotation::Daily, std::chrono::hours(48));
+    Logger::getInstance().setFile(true, temp_base.string());
+
+    std::time_t now = std::time(nullptr);
+    std::tm tm_buf = *std::localtime(&now);
+    tm_buf.tm_hour = 0;
+    tm_buf.tm_min = 0;
+    tm_buf.tm_sec = 5;
+    tm_buf.tm_mday += 1;
+    tm_buf.tm_isdst = -1;
+    std::time_t tomorrow = std::mktime(&tm_buf);
+    char suffix[16];
+    std::strftime(suffix, sizeof(suffix), "%Y%m%d", &tm_buf);
+    std::string tomorrow_file = (std::filesystem::temp_directory_path() /
+                                 (std::string("test_rotate_daily-") + suffix + ".log")).string();
+
+    // Wait for the standby file to appear before the boundary is crossed
+    for (int i = 0; i < 500 && !std::filesystem::exists(tomorrow_file); ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    EXPECT_TRUE(std::filesystem::exists(tomorrow_file));
+
+    const char today_msg[] = "before midnight";
+    const char tomorrow_msg[] = "after midnight";
+    Logger::getInstance().log(LogRecord{LogLevel::INFO, 1, "test.cpp", now, 0, 0, 0,
+                                        today_msg, sizeof(today_msg) - 1, false});
+    Logger::getInstance().log(LogRecord{LogLevel::INFO, 2, "test.cpp", tomorrow, 0, 0, 0,
+                                        tomorrow_msg, sizeof(tomorrow_msg) - 1, false});
+    Logger::getInstance().setFile(false, "");
+    Logger::getInstance().setFileRotation(FileRotation::Daily);
+
+    auto found_files = findFilesWithPattern("test_rotate_daily.log");
+    ASSERT_EQ(found_files.size(), 2u);
+    std::string tomorrow_content = readFileContent(tomorrow_file);
+    EXPECT_NE(tomorrow_content.find("00:00:05 [INFO] test.cpp:2 - after midnight"), std::string::npos);
+    EXPECT_EQ(tomorrow_content.find("before midnight"), std::string::npos);
+    for (const auto& f : found_files) {
+        if (f != tomorrow_file) {
+            EXPECT_NE(readFileContent(f).find("before midnight"), std::string::npos);
+        }
+        std::filesystem::remove(f);
+    }
+}
+
+// Test 23: Hourly rotation names files by hour and opens late files synchronously
+TEST_F(FileOutputTest, HourlyRotationNaming) {
+    test_utils::TempFile temp_base("test_rotate_hourly.log");
+    // No lead: the next file is opened on the write path when the boundary is crossed
+    Logger::getInstance().setFileRotation(FileRotation::Hourly, std::chrono::seconds(0));
+    EXPECT_EQ(Logger::getInstance().getFileRotation(), FileRotation::Hourly);
+    Logger::getInstance().setFile(true, temp_base.string());
+
+    std::time_t next_hour = std::time(nullptr) + 3600;
+    const char msg[] = "next hour";
+    Logger::info() << "this hour";
+    Logger::getInstance().log(LogRecord{LogLevel::INFO, 3, "test.cpp", next_hour, 0, 0, 0,
+                                        msg, sizeof(msg) - 1, false});
+    Logger::getInstance().setFile(false, "");
+    Logger::getInstance().setFileRotation(FileRotation::Daily);
+
+    char suffix[24];
+    std::strftime(suffix, sizeof(suffix), "-%Y%m%d-%H.log", std::localtime(&next_hour));
+    auto found_files = findFilesWithPattern("test_rotate_hourly.log");
+    ASSERT_EQ(found_files.size(), 2u);
+    for (const auto& f : found_files) {
+        std::regex pattern(".*test_rotate_hourly-\\d{8}-\\d{2}\\.log$");
+        EXPECT_TRUE(std::regex_match(f, pattern)) << f;
+        std::string content = readFileContent(f);
+        if (f.size() >= std::strlen(suffix) && f.compare(f.size() - std::strlen(suffix), std::string::npos, suffix) == 0) {
+            EXPECT_NE(content.find("next hour"), std::string::npos);
+            EXPECT_EQ(content.find("this hour"), std::string::npos);
+        } else {
+            EXPECT_NE(content.find("this hour"), std::string::npos);
+        }
+        std::filesystem::remove(f);
+    }
+}
+
+// Test 24: Size-based rotation moves to numbered files within the same day
+TEST_F(FileOutputTest, SizeRotationNumbersFiles) {
+    test_utils::TempFile temp_base("test_rotate_size.log");
+    FileSizeLimit limit;
+    limit.maxBytes = 1000;
+    Logger::getInstance().setFileSizeLimit(limit);
+    Logger::getInstance().setFile(true, temp_base.string());
+
+    for (int i = 0; i < 100; ++i) {
+        char seq[8];
+        std::snprintf(seq, sizeof(seq), "%03d", i);
+        Logger::info() << "size rotation record " << seq;
+    }
+    Logger::getInstance().setFile(false, "");
+    Logger::getInstance().setFileSizeLimit(FileSizeLimit{});
+
+    auto found_files = findFilesWithPattern("test_rotate_size.log");
+    EXPECT_GT(found_files.size(), 5u);
+
+    // Order files by their sequence number: base-YYYYMMDD.log, base-YYYYMMDD.1.log, ...
+    std::regex pattern(".*test_rotate_size-\\d{8}(?:\\.(\\d+))?\\.log$");
+    std::vector<std::pair<int, std::string>> ordered;
+    for (const auto& f : found_files) {
+        std::smatch match;
+        ASSERT_TRUE(std::regex_match(f, match, pattern)) << f;
+        ordered.emplace_back(match[1].matched ? std::stoi(match[1].str()) : 0, f);
+    }
+    std::sort(ordered.begin(), ordered.end());
+
+    std::string all;
+    for (size_t i = 0; i < ordered.size(); ++i) {
+        EXPECT_EQ(ordered[i].first, static_cast<int>(i));
+        std::string content = readFileContent(ordered[i].second);
+        EXPECT_LE(content.size(), 1000u) << ordered[i].second;
+        EXPECT_FALSE(content.empty()) << ordered[i].second;
+        all += content;
+        std::filesystem::remove(ordered[i].second);
+    }
+
+    std::istringstream lines(all);
+    std::string line;
+    int expected = 0;
+    while (std::getline(lines, line)) {
+        char tail[16];
+        std::snprintf(tail, sizeof(tail), "%03d", expected);
+        EXPECT_EQ(line.substr(line.size() - 3), tail);
+        ++expected;
+    }
+    EXPECT_EQ(expected, 100);
+}
+
+// Test 25: Record-count rotation and removal of the unused standby file
+TEST_F(FileOutputTest, RecordCountRotation) {
+    test_utils::TempFile temp_base("test_rotate_count.log");
+    FileSizeLimit limit;
+    limit.maxRecords = 10;
+    Logger::getInstance().setFileSizeLimit(limit);
+    EXPECT_EQ(Logger::getInstance().getFileSizeLimit().maxRecords, 10u);
+    Logger::getInstance().setFile(true, temp_base.string());
+
+    for (int i = 0; i < 35; ++i) {
+        Logger::info() << "count rotation " << i;
+    }
+    Logger::getInstance().setFile(false, "");
+    Logger::getInstance().setFileSizeLimit(FileSizeLimit{});
+
+    // Four files hold 10 + 10 + 10 + 5 records; the pre-opened fifth file was empty and removed
+    auto found_files = findFilesWithPattern("test_rotate_count.log");
+    EXPECT_EQ(found_files.size(), 4u);
+    size_t total = 0;
+    for (const auto& f : found_files) {
+        std::string content = readFileContent(f);
+        size_t records = std::count(content.begin(), content.end(), '\n');
+        EXPECT_LE(records, 10u) << f;
+        total += records;
+        std::filesystem::remove(f);
+    }
+    EXPECT_EQ(total, 35u);
+}
+
+// Test 26: Rotated files are compressed in parallel chunks into valid gzip files
+TEST_F(FileOutputTest, RotatedFilesAreCompressed) {
+    if (!LogCompressor::available()) {
+        GTEST_SKIP() << "Built without zlib";
+    }
+    test_utils::TempFile temp_base("test_rotate_gz.log");
+    FileCompression compression;
+    compression.enabled = true;
+    compression.threads = 4;
+    compression.chunkSize = 64 * 1024;
+    Logger::getInstance().setFileCompression(compression);
+    FileSizeLimit limit;
+    limit.maxBytes = 400 * 1024;
+    Logger::getInstance().setFileSizeLimit(limit);
+    Logger::getInstance().setFile(true, temp_base.string());
+
+    std::string expected;
+    for (int i = 0; i < 20000; ++i) {
+        Logger::info() << "compressed record " << i << " value " << (i * 7919) % 100003;
+        expected += "compressed record " + std::to_string(i) + " value " +
+                    std::to_string((i * 7919) % 100003) + "\n";
+    }
+    Logger::getInstance().waitFileCompression();
+    Logger::getInstance().setFile(false, "");
+    Logger::getInstance().setFileSizeLimit(FileSizeLimit{});
+    Logger::getInstance().setFileCompression(FileCompression{});
+
+    auto found_files = findFilesWithPattern("test_rotate_gz.log");
+    std::regex pattern(".*test_rotate_gz-\\d{8}(?:\\.(\\d+))?\\.log(\\.gz)?$");
+    std::vector<std::pair<int, std::string>> ordered;
+    size_t compressed = 0;
+    for (const auto& f : found_files) {
+        std::smatch match;
+        ASSERT_TRUE(std::regex_match(f, match, pattern)) << f;
+        ordered.emplace_back(match[1].matched ? std::stoi(match[1].str()) : 0, f);
+        compressed += match[2].matched ? 1 : 0;
+    }
+    std::sort(ordered.begin(), ordered.end());
+    // Every rotated file was replaced by its .gz; only the last file stays plain
+    EXPECT_GE(compressed, 2u);
+    EXPECT_EQ(compressed + 1, ordered.size());
+
+    std::string content;
+    for (const auto& [index, f] : ordered) {
+        std::string data = readFileContent(f);
+        if (f.size() > 3 && f.compare(f.size() - 3, 3, ".gz") == 0) {
+            EXPECT_LT(data.size(), 400u * 1024 / 3) << f;
+#ifdef LOGGER_HAS_ZLIB
+            z_stream zs{};
+            ASSERT_EQ(inflateInit2(&zs, 16 + 15), Z_OK);
+            std::string plain(4 << 20, '\0');
+            zs.next_in = reinterpret_cast<Bytef*>(data.data());
+            zs.avail_in = static_cast<uInt>(data.size());
+            zs.next_out = reinterpret_cast<Bytef*>(plain.data());
+            zs.avail_out = static_cast<uInt>(plain.size());
+            EXPECT_EQ(inflate(&zs, Z_FINISH), Z_STREAM_END) << f;
+            EXPECT_EQ(zs.avail_in, 0u) << f;
+            plain.resize(zs.total_out);
+            inflateEnd(&zs);
+            data = plain;
+#endif
+        }
+        content += data;
+        std::filesystem::remove(f);
+    }
+
+    // Strip the timestamp/level/location prefix from each line before comparing
+    std::istringstream lines(content);
+    std::string line;
+    std::string messages;
+    while (std::getline(lines, line)) {
+        messages += line.substr(line.find(" - ") + 3) + "\n";
+    }
+    EXPECT_EQ(messages, expected);
+}
+
+// Test 27: Retention keeps the newest rotated files within count and byte budgets
+TEST_F(FileOutputTest, RetentionKeepsNewestFiles) {
+    auto dir = std::filesystem::temp_directory_path() / "logger_retention_count";
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+
+    // Leftovers from earlier runs, plus an unrelated file that must survive
+    for (const char* name : {"app-20200101.log", "app-20200102.log.gz", "app-20200103.1.log"}) {
+        std::ofstream(dir / name) << "old content\n";
+        std::filesystem::last_write_time(dir / name,
+            std::filesystem::file_time_type::clock::now() - std::chrono::hours(24 * 30));
+    }
+    std::ofstream(dir / "app-notes.txt") << "keep me\n";
+
+    FileRetention retention;
+    retention.maxFiles = 3;
+    retention.maxTotalBytes = 64 * 1024;
+    Logger::getInstance().setFileRetention(retention);
+    EXPECT_EQ(Logger::getInstance().getFileRetention().maxFiles, 3u);
+    FileSizeLimit limit;
+    limit.maxBytes = 8 * 1024;
+    Logger::getInstance().setFileSizeLimit(limit);
+    Logger::getInstance().setFile(true, (dir / "app.log").string());
+
+    for (int i = 0; i < 2000; ++i) {
+        Logger::info() << "retained record " << i;
+    }
+    Logger::getInstance().waitFileRetention();
+
+    std::vector<std::string> rotated;
+    uint64_t rotated_bytes = 0;
+    bool active_found = false;
+    for (const auto& entry : std::filesystem::directory_iterator(dir)) {
+        std::string name = entry.path().filename().string();
+        EXPECT_EQ(name.find("app-2020"), std::string::npos) << name;
+        if (name == "app-notes.txt" || entry.file_size() == 0) continue;
+        if (readFileContent(entry.path().string()).find("retained record 1999") != std::string::npos) {
+            active_found = true;
+            continue;
+        }
+        rotated.push_back(name);
+        rotated_bytes += entry.file_size();
+    }
+    Logger::getInstance().setFile(false, "");
+    Logger::getInstance().setFileSizeLimit(FileSizeLimit{});
+    Logger::getInstance().setFileRetention(FileRetention{});
+
+    EXPECT_TRUE(active_found);
+    EXPECT_EQ(rotated.size(), 3u);
+    EXPECT_LE(rotated_bytes, 64u * 1024);
+    EXPECT_TRUE(std::filesystem::exists(dir / "app-notes.txt"));
+    std::filesystem::remove_all(dir);
+}
+
+// Test 28: Retention removes files older than the age budget when the log is opened
+TEST_F(FileOutputTest, RetentionRemovesExpiredFiles) {
+    auto dir = std::filesystem::temp_directory_path() / "logger_retention_age";
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+
+    auto now = std::filesystem::file_time_type::clock::now();
+    std::ofstream(dir / "app-20200101.log") << "expired\n";
+    std::filesystem::last_write_time(dir / "app-20200101.log", now - std::chrono::hours(24 * 10));
+    std::ofstream(dir / "app-20200102.log") << "recent\n";
+    std::filesystem::last_write_time(dir / "app-20200102.log", now - std::chrono::hours(24));
+
+    FileRetention retention;
+    retention.maxAge = std::chrono::hours(24 * 7);
+    Logger::getInstance().setFileRetention(retention);
+    Logger::getInstance().setFile(true, (dir / "app.log").string());
+    Logger::info() << "age retention";
+    Logger::getInstance().waitFileRetention();
+
+    EXPECT_FALSE(std::filesystem::exists(dir / "app-20200101.log"));
+    EXPECT_TRUE(std::filesystem::exists(dir / "app-20200102.log"));
+
+    Logger::getInstance().setFile(false, "");
+    Logger::getInstance().setFileRetention(FileRetention{});
+    std::filesystem::remove_all(dir);
+}
+
+// Test 29: Preallocation reserves space beyond EOF and trims it at close
+TEST_F(FileOutputTest, PreallocationReservesAndTrims) {
+#ifndef __linux__
+    GTEST_SKIP() << "fallocate is Linux-only";
+#else
+    auto allocated = [](const std::string& path) {
+        struct stat st;
+        return ::stat(path.c_str(), &st) == 0 ? static_cast<uint64_t>(st.st_blocks) * 512 : 0;
+    };
+
+    for (FileBackend backend : {FileBackend::Stdio, FileBackend::DoubleBuffered, FileBackend::IoUring}) {
+        test_utils::TempFile temp_base("test_prealloc.log");
+        Logger::getInstance().setFileBackend(backend);
+        Logger::getInstance().setFilePreallocation(4 << 20);
+        EXPECT_EQ(Logger::getInstance().getFilePreallocation(), size_t(4 << 20));
+        Logger::getInstance().setFile(true, temp_base.string());
+
+        for (int i = 0; i < 100; ++i) {
+            Logger::info() << "preallocated record " << i;
+        }
+        Logger::getInstance().drain();
+
+        auto found_files = findFilesWithPattern("test_prealloc.log");
+        ASSERT_EQ(found_files.size(), 1u);
+        const std::string path = found_files[0];
+        const uint64_t size = std::filesystem::file_size(path);
+        if (allocated(path) < (4u << 20)) {
+            Logger::getInstance().setFile(false, "");
+            Logger::getInstance().setFilePreallocation(0);
+            Logger::getInstance().setFileBackend(FileBackend::Stdio);
+            std::filesystem::remove(path);
+            GTEST_SKIP() << "Filesystem does not support fallocate";
+        }
+        // The reservation does not change the visible size
+        EXPECT_LT(size, 1u << 20);
+        EXPECT_EQ(readFileContent(path).size(), size);
+
+        Logger::getInstance().setFile(false, "");
+        Logger::getInstance().setFilePreallocation(0);
+        Logger::getInstance().setFileBackend(FileBackend::Stdio);
+
+        // The unused tail is released and the content is intact
+        EXPECT_LT(allocated(path), 1u << 20);
+        std::string content = readFileContent(path);
+        EXPECT_EQ(std::count(content.begin(), content.end(), '\n'), 100);
+        EXPECT_NE(content.find("preallocated record 99\n"), std::string::npos);
+        std::filesystem::remove(path);
+    }
+#endif
+}
+
+// Test 30: UTC timestamps end in Z and name files by UTC date; cached local time matches localtime
+TEST_F(FileOutputTest, TimeZoneModes) {
+    test_utils::TempFile temp_base("test_timezone.log");
+    Logger::getInstance().setTimeZone(TimeZoneMode::Utc);
+    EXPECT_EQ(Logger::getInstance().getTimeZone(), TimeZoneMode::Utc);
+    Logger::getInstance().setTimePrecision(TimePrecision::Milliseconds);
+    Logger::getInstance().setFile(true, temp_base.string());
+
+    const std::time_t now = std::time(nullptr);
+    const char msg[] = "zoned";
+    const LogRecord record{LogLevel::INFO, 1, "test.cpp", now, 7000000, 0, 0, msg, sizeof(msg) - 1, false};
+    Logger::getInstance().log(record);
+    Logger::getInstance().setFile(false, "");
+
+    char utc_day[16];
+    char utc_stamp[32];
+    std::tm utc_tm = *std::gmtime(&now);
+    std::strftime(utc_day, sizeof(utc_day), "%Y%m%d", &utc_tm);
+    std::strftime(utc_stamp, sizeof(utc_stamp), "%Y-%m-%d %H:%M:%S", &utc_tm);
+    const std::string utc_file = (std::filesystem::temp_directory_path() /
+                                  (std::string("test_timezone-") + utc_day + ".log")).string();
+    EXPECT_EQ(readFileContent(utc_file), std::string(utc_stamp) + ".007Z [INFO] test.cpp:1 - zoned\n");
+    std::filesystem::remove(utc_file);
+
+    char local_stamp[32];
+    std::tm local_tm = *std::localtime(&now);
+    std::strftime(local_stamp, sizeof(local_stamp), "%Y-%m-%d %H:%M:%S", &local_tm);
+    Logger::getInstance().setTimeZone(TimeZoneMode::Local);
+    Logger::getInstance().setFile(true, temp_base.string());
+    for (TimeZoneMode mode : {TimeZoneMode::Local, TimeZoneMode::CachedLocal}) {
+        Logger::getInstance().setTimeZone(mode);
+        Logger::getInstance().log(record);
+    }
+    Logger::getInstance().setFile(false, "");
+    Logger::getInstance().setTimeZone(TimeZoneMode::Local);
+    Logger::getInstance().setTimePrecision(TimePrecision::Seconds);
+
+    auto found_files = findFilesWithPattern("test_timezone.log");
+    ASSERT_EQ(found_files.size(), 1u);
+    const std::string line = std::string(local_stamp) + ".007 [INFO] test.cpp:1 - zoned\n";
+    EXPECT_EQ(readFileContent(found_files[0]), line + line);
+    std::filesystem::remove(found_files[0]);
+}
+
+// Test 31: The cached local offset follows daylight saving transitions to the second
+TEST_F(FileOutputTest, CachedLocalOffsetTracksDst) {
+    const char* saved = std::getenv("TZ");
+    const std::string previous = saved ? saved : "";
+    setenv("TZ", "EST5EDT,M3.2.0,M11.1.0", 1);
+    tzset();
+
+    auto expect_same = [](LogTimeZone& zone, std::time_t t) {
+        std::tm tm_buf;
+        localtime_r(&t, &tm_buf);
+        const LogTimeZone::Civil c = zone.toCivil(t);
+        EXPECT_EQ(c.year, tm_buf.tm_year + 1900) << t;
+        EXPECT_EQ(c.month, static_cast<unsigned>(tm_buf.tm_mon + 1)) << t;
+        EXPECT_EQ(c.day, static_cast<unsigned>(tm_buf.tm_mday)) << t;
+        EXPECT_EQ(c.hour, static_cast<unsigned>(tm_buf.tm_hour)) << t;
+        EXPECT_EQ(c.minute, static_cast<unsigned>(tm_buf.tm_min)) << t;
+        EXPECT_EQ(c.second, static_cast<unsigned>(tm_buf.tm_sec)) << t;
+    };
+
+    LogTimeZone zone(TimeZoneMode::CachedLocal);
+    // 2024-03-10 07:00:00 UTC and 2024-11-03 06:00:00 UTC are the transitions
+    for (std::time_t transition : {std::time_t(1710054000), std::time_t(1730613600)}) {
+        for (std::time_t t = transition - 3; t <= transition + 3; ++t) {
+            expect_same(zone, t);
+        }
+    }
+    // Two years sampled every 37 minutes, in order and then backwards
+    for (std::time_t t = 1704067200; t < 1767225600; t += 37 * 60) {
+        expect_same(zone, t);
+    }
+    for (std::time_t t = 1767225600; t > 1704067200; t -= 37 * 60) {
+        expect_same(zone, t);
+    }
+    EXPECT_EQ(zone.fromCivil(2024, 3, 10), std::time_t(1710046800));
+    EXPECT_EQ(zone.fromCivil(2024, 3, 11), std::time_t(1710129600));
+
+    if (saved) {
+        setenv("TZ", previous.c_str(), 1);
+    } else {
+        unsetenv("TZ");
+    }
+    tzset();
+}
+
+#ifndef _WIN32
+// Test 32: A failed O_DIRECT write keeps its data and offset; the next batch rewrites it without a hole
+TEST_F(FileOutputTest, DirectWriterRetriesFailedWrite) {
+    test_utils::TempFile temp_file("test_direct_retry.log");
+    std::filesystem::remove(temp_file.path());
+
+    DirectFileWriter writer(64 * 1024);
+    ASSERT_TRUE(writer.open(temp_file.string(), FileCommitPolicy{}));
+
+    // Cap the file size so pwrite fails with EFBIG instead of raising SIGXFSZ
+    struct rlimit saved;
+    ASSERT_EQ(getrlimit(RLIMIT_FSIZE, &saved), 0);
+    auto previous = std::signal(SIGXFSZ, SIG_IGN);
+    struct rlimit capped = saved;
+    capped.rlim_cur = 8192;
+    ASSERT_EQ(setrlimit(RLIMIT_FSIZE, &capped), 0);
+
+    std::string expected;
+    for (int i = 0; i < 1000; ++i) {
+        std::string record = "retry record " + std::to_string(i) + "\n";
+        expected += record;
+        writer.write(record.data(), record.size());
+    }
+    writer.commit(FileDurability::FlushToKernel);
+    EXPECT_LE(std::filesystem::file_size(temp_file.path()), 8192u);
+
+    ASSERT_EQ(setrlimit(RLIMIT_FSIZE, &saved), 0);
+    std::signal(SIGXFSZ, previous);
+
+    // The retained batch is rewritten from the same offset, even when nothing new arrives
+    writer.commit(FileDurability::FlushToKernel);
+    std::string tail = "after recovery\n";
+    expected += tail;
+    writer.write(tail.data(), tail.size());
+    writer.close();
+
+    EXPECT_EQ(readFileContent(temp_file.string()), expected);
+    EXPECT_EQ(writer.droppedBytes(), 0u);
+}
+#endif
+
+#ifdef LOGGER_HAS_IO_URING
+// io_uring instances currently open in this process
+static std::vector<int> io_uring_fds() {
+    std::vector<int> fds;
+    for (const auto& entry : std::filesystem::directory_iterator("/proc/self/fd")) {
+        std::error_code ec;
+        auto target = std::filesystem::read_symlink(entry.path(), ec);
+        if (!ec && target.string().find("io_uring") != std::string::npos) {
+            fds.push_back(std::stoi(entry.path().filename().string()));
+        }
+    }
+    return fds;
+}
+
+// Test 33: A failing io_uring_enter degrades the writer to pwrite without losing or hanging on data
+TEST_F(FileOutputTest, IoUringWriterDegradesOnEnterFailure) {
+    if (!IoUringFileWriter::available()) GTEST_SKIP() << "io_uring with IORING_OP_WRITE unavailable";
+    test_utils::TempFile temp_file("test_uring_degrade.log");
+    std::filesystem::remove(temp_file.path());
+
+    const auto before = io_uring_fds();
+    IoUringFileWriter writer(4096);
+    ASSERT_TRUE(writer.open(temp_file.string(), FileCommitPolicy{}));
+    std::vector<int> ring_fds;
+    for (int fd : io_uring_fds()) {
+        if (std::find(before.begin(), before.end(), fd) == before.end()) ring_fds.push_back(fd);
+    }
+    ASSERT_EQ(ring_fds.size(), 1u);
+
+    std::string expected;
+    auto write_records = [&](const std::string& tag) {
+        for (int i = 0; i < 2000; ++i) {
+            std::string record = tag + " " + std::to_string(i) + "\n";
+            expected += record;
+            writer.write(record.data(), record.size());
+        }
+    };
+    write_records("ring");
+    writer.commit(FileDurability::FlushToKernel);
+    EXPECT_FALSE(writer.degraded());
+
+    // Replace the ring descriptor so every io_uring_enter fails persistently
+    int null_fd = ::open("/dev/null", O_RDONLY);
+    ASSERT_GE(null_fd, 0);
+    ASSERT_EQ(::dup2(null_fd, ring_fds[0]), ring_fds[0]);
+    ::close(null_fd);
+
+    write_records("degraded");
+    writer.commit(FileDurability::Fdatasync);
+    writer.close();
+
+    EXPECT_TRUE(writer.degraded());
+    EXPECT_EQ(readFileContent(temp_file.string()), expected);
+}
+#endif
+
+#if defined(LOGGER_HAS_MMAP) && !defined(_WIN32)
+// Test 34: A failed segment mapping drops and counts only that segment's bytes; later segments recover
+TEST_F(FileOutputTest, MmapWriterRecoversFromMappingFailure) {
+    test_utils::TempFile temp_file("test_mmap_recover.log");
+    std::filesystem::remove(temp_file.path());
+
+    struct rlimit saved;
+    ASSERT_EQ(getrlimit(RLIMIT_FSIZE, &saved), 0);
+    auto previous = std::signal(SIGXFSZ, SIG_IGN);
+    struct rlimit capped = saved;
+    capped.rlim_cur = 8192;
+    ASSERT_EQ(setrlimit(RLIMIT_FSIZE, &capped), 0);
+
+    MmapFileWriter writer(4096);
+    ASSERT_TRUE(writer.open(temp_file.string(), FileCommitPolicy{}));
+    const std::string record(64, 'a');
+    for (int i = 0; i < 4 * 4096 / 64; ++i) {
+        writer.write(record.data(), record.size());
+    }
+    // Segments 2 and 3 lie beyond the size limit
+    EXPECT_EQ(writer.droppedBytes(), 2u * 4096);
+
+    ASSERT_EQ(setrlimit(RLIMIT_FSIZE, &saved), 0);
+    std::signal(SIGXFSZ, previous);
+    // The mapping thread retries the failed segment on its next round
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    const std::string tail = "after recovery\n";
+    writer.write(tail.data(), tail.size());
+    writer.close();
+
+    EXPECT_EQ(writer.droppedBytes(), 2u * 4096);
+    std::string content = readFileContent(temp_file.string());
+    ASSERT_EQ(content.size(), 4u * 4096 + tail.size());
+    EXPECT_EQ(content.substr(0, 2 * 4096), std::string(2 * 4096, 'a'));
+    EXPECT_EQ(content.substr(4 * 4096), tail);
+}
+#endif
+
+// Test 35: Destroying the sink right after several rotations still compresses every rotated file
+TEST_F(FileOutputTest, CompressorDrainsQueueOnShutdown) {
+    if (!LogCompressor::available()) {
+        GTEST_SKIP() << "Built without zlib";
+    }
+    test_utils::TempFile temp_base("test_gz_shutdown.log");
+    auto sink = std::make_shared<FileSink>();
+    FileCompression compression;
+    compression.enabled = true;
+    compression.threads = 2;
+    compression.chunkSize = 64 * 1024;
+    sink->setCompression(compression);
+    FileSizeLimit limit;
+    limit.maxBytes = 256 * 1024;
+    sink->setSizeLimit(limit);
+    ASSERT_TRUE(sink->open(temp_base.string()));
+
+    LogRenderer renderer;
+    const std::string message(100, 'x');
+    for (int batch = 0; batch < 100; ++batch) {
+        renderer.clear();
+        for (int i = 0; i < 100; ++i) {
+            renderer.append(LogRecord{LogLevel::INFO, __LINE__, __FILE__, std::time(nullptr), 0, 0, 0,
+                                      message.data(), message.size(), false});
+        }
+        sink->consume(renderer.lines());
+    }
+    sink.reset();
+
+    auto found_files = findFilesWithPattern("test_gz_shutdown.log");
+    std::regex pattern(".*test_gz_shutdown-\\d{8}(?:\\.(\\d+))?\\.log(\\.gz)?$");
+    size_t compressed = 0;
+    size_t plain = 0;
+    for (const auto& f : found_files) {
+        std::smatch match;
+        EXPECT_TRUE(std::regex_match(f, match, pattern)) << f;
+        (match[2].matched ? compressed : plain) += 1;
+        std::filesystem::remove(f);
+    }
+    // Only the file that was open at shutdown stays plain; no .gz.tmp is left behind
+    EXPECT_GE(compressed, 3u);
+    EXPECT_EQ(plain, 1u);
+}
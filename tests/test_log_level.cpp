@@ -1,5 +1,7 @@
 #include <gtest/gtest.h>
 #include "Logger.hpp"
+#include <fstream>
+#include <iterator>
 
 class LogLevelTest : public ::testing::Test {
 protected:
@@ -99,3 +101,65 @@ TEST(LogLevelValidTest, AllLevelsValid) {
         EXPECT_LE(level, LogLevel::ERROR);
     }
 }
+
+// Test 9: Guarded macros skip disabled calls without evaluating their operands
+TEST_F(LogLevelTest, MacrosSkipDisabledOperands) {
+    class CountingSink : public LogSink {
+    public:
+        std::atomic<int> lines{0};
+    protected:
+        void write(std::span<const LogLine> batch) override { lines += static_cast<int>(batch.size()); }
+    };
+
+    Logger& logger = Logger::getInstance();
+    logger.setConsole(false);
+    auto sink = std::make_shared<CountingSink>();
+    logger.addSink(sink);
+
+    int evaluated = 0;
+    auto expensive = [&evaluated]() {
+        ++evaluated;
+        return std::string(256, 'x');
+    };
+
+    logger.setLevel(LogLevel::WARNING);
+    EXPECT_FALSE(Logger::isEnabled(LogLevel::INFO));
+    EXPECT_TRUE(Logger::isEnabled(LogLevel::WARNING));
+    LOG_DEBUG << "skipped " << expensive();
+    LOG_INFO << expensive() << 42;
+    EXPECT_EQ(evaluated, 0);
+    EXPECT_EQ(sink->lines, 0);
+
+    LOG_WARNING << "kept " << expensive();
+    LOG_ERROR << expensive();
+    EXPECT_EQ(evaluated, 2);
+    EXPECT_EQ(sink->lines, 2);
+
+    // The macro is a single expression, so an unbraced if/else binds as written
+    bool took_else = false;
+    if (evaluated < 0)
+        LOG_ERROR << "unreachable";
+    else
+        took_else = true;
+    EXPECT_TRUE(took_else);
+
+    logger.removeSink(sink);
+    logger.setConsole(true);
+}
+
+// Test 10: Calls below LOGGER_ACTIVE_LEVEL leave nothing in the object file
+TEST(CompileTimeLevelTest, DisabledCallsAreStripped) {
+    std::ifstream file(STRIP_LEVEL_PROBE_OBJECT, std::ios::binary);
+    ASSERT_TRUE(file.good()) << STRIP_LEVEL_PROBE_OBJECT;
+    const std::string object((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    // The kept INFO call is present, so the scan is meaningful
+    EXPECT_NE(object.find("probe macro info marker"), std::string::npos);
+    EXPECT_NE(object.find("probe_info_argument"), std::string::npos);
+
+    for (const char* stripped : {"probe stream debug marker", "probe macro debug marker",
+                                 "probe proxy debug marker", "probe function debug marker",
+                                 "probe guarded debug marker", "probe_debug_argument"}) {
+        EXPECT_EQ(object.find(stripped), std::string::npos) << stripped;
+    }
+}
@@ -259,3 +259,167 @@ TEST_F(LogStreamTest, MultipleTypesInOneStream) {
     EXPECT_TRUE(content.find("Bool:") != std::string::npos);
     EXPECT_TRUE(content.find("true") != std::string::npos);
 }
+
+// Test 16: Timestamp is sampled when the stream is created, not when it is written
+TEST_F(LogStreamTest, TimestampCapturedAtConstruction) {
+    Logger::getInstance().setTimePrecision(TimePrecision::Milliseconds);
+    std::string stamp_after;
+    auto content = capture_log([&stamp_after]() {
+        auto stream = Logger::info();
+        stream << "slow to build";
+        std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+        // Second-resolution reference taken after the delay, must be later than the record
+        std::time_t now = std::time(nullptr);
+        char buf[32];
+        std::strftime(buf, sizeof(buf), "%Y-%m-%d %H:%M:%S", std::localtime(&now));
+        stamp_after = buf;
+    });
+    Logger::getInstance().setTimePrecision(TimePrecision::Seconds);
+
+    ASSERT_NE(content.find("slow to build"), std::string::npos);
+    EXPECT_LT(content.substr(0, 19), stamp_after) << content;
+}
+
+// Test 17: Macro call sites carry a static descriptor and print the basename; other forms keep the caller's path
+TEST_F(LogStreamTest, CallSiteDescriptors) {
+    // The enclosing function is recovered from both GCC and Clang lambda names
+    static_assert(LogSite::functionName("f(int)::<lambda()>") == "f(int)");
+    static_assert(LogSite::functionName("const LogSite &f(int)::(anonymous class)::operator()() const") ==
+                  "f(int)");
+    static_assert(LogSite::functionName("const LogSite &ns::f()::(lambda at a.cpp:3:5)::operator()() const") ==
+                  "ns::f()");
+    static_assert(LogSite::functionName("void f()") == "void f()");
+
+    class SiteSink : public LogSink {
+    public:
+        std::vector<const LogSite*> sites;
+        std::vector<std::string> texts;
+    protected:
+        void write(std::span<const LogLine> lines) override {
+            for (const LogLine& line : lines) {
+                sites.push_back(line.site);
+                texts.emplace_back(line.text);
+            }
+        }
+    };
+    auto sink = std::make_shared<SiteSink>();
+    Logger::getInstance().addSink(sink);
+
+    int macro_line = 0;
+    for (int i = 0; i < 2; ++i) {
+        macro_line = __LINE__; LOG_WARNING << "from macro " << i;
+    }
+    const int proxy_line = __LINE__; lg::info << "from proxy";
+    const int function_line = __LINE__; Logger::error() << "from function";
+    Logger::getInstance().removeSink(sink);
+
+    ASSERT_EQ(sink->sites.size(), 4u);
+    const LogSite* site = sink->sites[0];
+    ASSERT_NE(site, nullptr);
+    EXPECT_EQ(sink->sites[1], site);  // One descriptor per call site
+    EXPECT_EQ(site->level, LogLevel::WARNING);
+    EXPECT_STREQ(site->file, "test_log_stream.cpp");
+    EXPECT_EQ(site->line, macro_line);
+    EXPECT_NE(site->function.find("CallSiteDescriptors"), std::string_view::npos) << site->function;
+    EXPECT_EQ(site->function.find("lambda"), std::string_view::npos) << site->function;
+    EXPECT_EQ(site->format, nullptr);
+
+    EXPECT_NE(sink->texts[0].find("[WARNING] test_log_stream.cpp:" + std::to_string(macro_line) +
+                                  " - from macro 0\n"), std::string::npos) << sink->texts[0];
+    const std::string at = std::string(__FILE__) + ":";
+    EXPECT_NE(sink->texts[2].find("[INFO] " + at + std::to_string(proxy_line) + " - from proxy\n"),
+              std::string::npos) << sink->texts[2];
+    EXPECT_NE(sink->texts[3].find("[ERROR] " + at + std::to_string(function_line) + " - from function\n"),
+              std::string::npos) << sink->texts[3];
+}
+
+// Test 18: {} format API checks the format at compile time and writes std::format-style text
+TEST_F(LogStreamTest, FormatApi) {
+    static_assert(LogFormatString<int, double>::check("order {} filled at {:.2f}") == nullptr);
+    static_assert(LogFormatString<int>::check("{} {}") != nullptr);
+    static_assert(LogFormatString<int, int>::check("{}") != nullptr);
+    static_assert(LogFormatString<int>::check("{:.2f}") != nullptr);
+    static_assert(LogFormatString<std::string>::check("{:05}") != nullptr);
+    static_assert(LogFormatString<>::check("{{literal}}") == nullptr);
+    static_assert(LogFormatString<>::check("unmatched }") != nullptr);
+
+    int line = 0;
+    std::string output = capture_log([&line]() {
+        const std::string name = "alice";
+        line = __LINE__; Logger::infof("order {} filled at {:.2f}", 42, 101.256);
+        Logger::warningf("[{:>6}|{:<6}|{:^7}|{:*^9}]", 7, name, "ab", "mid");
+        Logger::errorf("{:08.3f} {:x} {:X} {:b} {:o} {:05}", -3.14159, 255, 255, 5, 8, -7);
+        Logger::debugf("{} {:d} {} {:c} {:.2s} {} {:e} {{}} }}", true, false, 'A', 66, "hello", 0.1, 12345.678);
+        Logger::infof("{} {}", nullptr, std::string_view("view"));
+        Logger::infof("float {} {} {:.3f} long {}", 0.1f, -2.5f, 1.0f / 3, 0.1L);
+        LOG_INFOF("macro {}", name);
+        LOG_WARNINGF("no arguments");
+    });
+
+    EXPECT_NE(output.find("[INFO] test_log_stream.cpp:" + std::to_string(line) +
+                          " - order 42 filled at 101.26\n"), std::string::npos) << output;
+    EXPECT_NE(output.find(" - [     7|alice |  ab   |***mid***]\n"), std::string::npos) << output;
+    EXPECT_NE(output.find(" - -003.142 ff FF 101 10 -0007\n"), std::string::npos) << output;
+    EXPECT_NE(output.find(" - true 0 A B he 0.1 1.234568e+04 {} }\n"), std::string::npos) << output;
+    EXPECT_NE(output.find(" - 0x0 view\n"), std::string::npos) << output;
+    // Floats use their own shortest representation, as std::format does
+    EXPECT_NE(output.find(" - float 0.1 -2.5 0.333 long 0.1\n"), std::string::npos) << output;
+    EXPECT_NE(output.find(" - macro alice\n"), std::string::npos) << output;
+    EXPECT_NE(output.find("[WARNING] test_log_stream.cpp:" + std::to_string(line + 7) + " - no arguments\n"),
+              std::string::npos) << output;
+}
+
+// Test 19: Formatted text longer than the record buffer is truncated like the stream path
+TEST_F(LogStreamTest, FormatApiTruncates) {
+    const std::string big(5000, 'y');
+    std::string output = capture_log([&big]() {
+        Logger::infof("start {} end", big);
+        Logger::infof("after");
+    });
+
+    size_t start = output.find("start ");
+    ASSERT_NE(start, std::string::npos);
+    size_t newline = output.find('\n', start);
+    EXPECT_EQ(newline - start, 4095u);
+    EXPECT_NE(output.find(" - after\n"), std::string::npos);
+}
+
+// Test 20: Function-form format calls get one registered descriptor per call site, so the prefix is cached
+TEST_F(LogStreamTest, FormatApiCallSiteDescriptors) {
+    class SiteSink : public LogSink {
+    public:
+        std::vector<const LogSite*> sites;
+        std::vector<std::string> texts;
+    protected:
+        void write(std::span<const LogLine> lines) override {
+            for (const LogLine& line : lines) {
+                sites.push_back(line.site);
+                texts.emplace_back(line.text);
+            }
+        }
+    };
+    auto sink = std::make_shared<SiteSink>();
+    Logger::getInstance().addSink(sink);
+
+    int line = 0;
+    for (int i = 0; i < 2; ++i) {
+        line = __LINE__; Logger::infof("formatted {}", i);
+    }
+    Logger::warningf("other site");
+    Logger::getInstance().removeSink(sink);
+
+    ASSERT_EQ(sink->sites.size(), 3u);
+    const LogSite* site = sink->sites[0];
+    ASSERT_NE(site, nullptr);
+    EXPECT_EQ(sink->sites[1], site);
+    EXPECT_NE(sink->sites[2], site);
+    EXPECT_EQ(site->level, LogLevel::INFO);
+    EXPECT_STREQ(site->file, "test_log_stream.cpp");
+    EXPECT_EQ(site->line, line);
+    EXPECT_STREQ(site->format, "formatted {}");
+    EXPECT_NE(site->function.find("FormatApiCallSiteDescriptors"), std::string_view::npos) << site->function;
+    ASSERT_NE(site->prefix, nullptr);
+    EXPECT_TRUE(site->prefix->ready());
+    EXPECT_NE(sink->texts[1].find("[INFO] test_log_stream.cpp:" + std::to_string(line) + " - formatted 1\n"),
+              std::string::npos) << sink->texts[1];
+}
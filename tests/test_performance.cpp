@@ -4,6 +4,8 @@
 #include <chrono>
 #include <vector>
 #include <thread>
+#include <algorithm>
+#include <limits>
 
 class PerformanceTest : public ::testing::Test {
 protected:
@@ -188,3 +190,327 @@ TEST_F(PerformanceTest, LevelComparisonPerformance) {
     // Level check should be very fast (atomic operation)
     EXPECT_LT(avg_ns, 100);  // Less than 100ns
 }
+
+// Test 7: Group commit vs per-record fflush file throughput
+TEST_F(PerformanceTest, GroupCommitThroughput) {
+    const int num_logs = 50000;
+
+    auto run = [num_logs](const std::string& name, const FileCommitPolicy& policy) {
+        test_utils::TempFile temp_base(name);
+        Logger::getInstance().setFileCommitPolicy(policy);
+        Logger::getInstance().setFile(true, temp_base.string());
+
+        auto start = std::chrono::high_resolution_clock::now();
+        for (int i = 0; i < num_logs; ++i) {
+            Logger::info() << "Group commit test message " << i;
+        }
+        Logger::getInstance().drain();
+        auto end = std::chrono::high_resolution_clock::now();
+
+        Logger::getInstance().setFile(false, "");
+        auto duration_us = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
+        return (num_logs * 1000000.0) / (duration_us.count() > 0 ? duration_us.count() : 1);
+    };
+
+    double per_record = run("perf_commit_each.log", FileCommitPolicy{});
+
+    FileCommitPolicy batched;
+    batched.flushBytes = 64 * 1024;
+    batched.flushInterval = std::chrono::milliseconds(100);
+    double group = run("perf_commit_group.log", batched);
+
+    batched.durability = FileDurability::Fdatasync;
+    double group_sync = run("perf_commit_group_sync.log", batched);
+
+    Logger::getInstance().setFileBackend(FileBackend::DoubleBuffered);
+    double double_buffered = run("perf_commit_double.log", FileCommitPolicy{});
+    Logger::getInstance().setFileBackend(FileBackend::Stdio);
+
+    Logger::getInstance().setFileCommitPolicy(FileCommitPolicy{});
+
+    std::cout << "Per-record fflush:           " << static_cast<int>(per_record) << " msg/sec" << std::endl;
+    std::cout << "Group commit (64 KiB):       " << static_cast<int>(group) << " msg/sec" << std::endl;
+    std::cout << "Group commit + fdatasync:    " << static_cast<int>(group_sync) << " msg/sec" << std::endl;
+    std::cout << "Double-buffered backend:     " << static_cast<int>(double_buffered) << " msg/sec" << std::endl;
+    std::cout << "Group commit speedup:        " << group / per_record << "x" << std::endl;
+
+    EXPECT_GT(per_record, 1000);
+    EXPECT_GT(double_buffered, 1000);
+    EXPECT_GT(group, 1000);
+    EXPECT_GT(group_sync, 1000);
+}
+
+// Test 8: File backend throughput and per-call tail latency
+TEST_F(PerformanceTest, FileBackendLatency) {
+    const int num_logs = 50000;
+
+    struct Result {
+        double throughput;
+        double p50_ns;
+        double p99_ns;
+        double p999_ns;
+        double max_ns;
+    };
+
+    auto run = [num_logs](const std::string& name, FileBackend backend) {
+        test_utils::TempFile temp_base(name);
+        Logger::getInstance().setFileBackend(backend);
+        Logger::getInstance().setFile(true, temp_base.string());
+
+        std::vector<int64_t> latencies(num_logs);
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < num_logs; ++i) {
+            auto t0 = std::chrono::steady_clock::now();
+            Logger::info() << "Backend latency test message " << i;
+            auto t1 = std::chrono::steady_clock::now();
+            latencies[i] = std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count();
+        }
+        Logger::getInstance().drain();
+        auto end = std::chrono::steady_clock::now();
+        Logger::getInstance().setFile(false, "");
+
+        std::sort(latencies.begin(), latencies.end());
+        auto pct = [&](double p) {
+            return static_cast<double>(latencies[static_cast<size_t>(p * (num_logs - 1))]);
+        };
+        auto duration_us = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+        return Result{(num_logs * 1000000.0) / (duration_us > 0 ? duration_us : 1),
+                      pct(0.50), pct(0.99), pct(0.999), static_cast<double>(latencies.back())};
+    };
+
+    auto print = [](const char* label, const Result& r) {
+        std::cout << label << static_cast<int>(r.throughput) << " msg/sec, p50 " << r.p50_ns
+                  << " ns, p99 " << r.p99_ns << " ns, p99.9 " << r.p999_ns
+                  << " ns, max " << r.max_ns << " ns" << std::endl;
+    };
+
+    Result stdio = run("perf_backend_stdio.log", FileBackend::Stdio);
+    Result uring = run("perf_backend_uring.log", FileBackend::IoUring);
+    Result mapped = run("perf_backend_mmap.log", FileBackend::Mmap);
+    Result direct = run("perf_backend_direct.log", FileBackend::Direct);
+    Logger::getInstance().setFileBackend(FileBackend::Stdio);
+
+    print("stdio + fflush: ", stdio);
+    print("io_uring:       ", uring);
+    print("mmap segments:  ", mapped);
+    print("O_DIRECT:       ", direct);
+
+    EXPECT_GT(stdio.throughput, 1000);
+    EXPECT_GT(uring.throughput, 1000);
+    EXPECT_GT(mapped.throughput, 1000);
+    EXPECT_GT(direct.throughput, 1000);
+}
+
+// Test 9: Timestamp precision cost (cached prefix, only sub-second digits rewritten)
+TEST_F(PerformanceTest, TimestampPrecisionCost) {
+    const int num_logs = 100000;
+
+    auto run = [num_logs](const std::string& name, TimePrecision precision) {
+        test_utils::TempFile temp_base(name);
+        FileCommitPolicy batched;
+        batched.flushBytes = 64 * 1024;
+        Logger::getInstance().setFileCommitPolicy(batched);
+        Logger::getInstance().setTimePrecision(precision);
+        Logger::getInstance().setFile(true, temp_base.string());
+
+        auto start = std::chrono::high_resolution_clock::now();
+        for (int i = 0; i < num_logs; ++i) {
+            Logger::info() << "Timestamp test message " << i;
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+
+        Logger::getInstance().setFile(false, "");
+        auto duration_us = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
+        return (num_logs * 1000000.0) / (duration_us.count() > 0 ? duration_us.count() : 1);
+    };
+
+    double seconds = run("perf_time_s.log", TimePrecision::Seconds);
+    double millis = run("perf_time_ms.log", TimePrecision::Milliseconds);
+    double nanos = run("perf_time_ns.log", TimePrecision::Nanoseconds);
+    Logger::getInstance().setTimePrecision(TimePrecision::Seconds);
+    Logger::getInstance().setFileCommitPolicy(FileCommitPolicy{});
+
+    std::cout << "Seconds:      " << static_cast<int>(seconds) << " msg/sec" << std::endl;
+    std::cout << "Milliseconds: " << static_cast<int>(millis) << " msg/sec" << std::endl;
+    std::cout << "Nanoseconds:  " << static_cast<int>(nanos) << " msg/sec" << std::endl;
+
+    EXPECT_GT(seconds, 1000);
+    EXPECT_GT(millis, 1000);
+    EXPECT_GT(nanos, 1000);
+}
+
+// Test 10: Call-site cost of the clock sources
+TEST_F(PerformanceTest, ClockSourceCallSiteCost) {
+    const int num_logs = 100000;
+
+    auto run = [num_logs](const std::string& name, ClockSource source) {
+        test_utils::TempFile temp_base(name);
+        Logger::getInstance().setClockSource(source);
+        Logger::getInstance().setFile(true, temp_base.string());
+        // Ring large enough to hold every record, so only the call site is measured
+        Logger::getInstance().setAsync(true, 32 << 20);
+
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < num_logs; ++i) {
+            Logger::info() << "Clock source test message " << i;
+        }
+        auto end = std::chrono::steady_clock::now();
+
+        Logger::getInstance().setAsync(false);
+        Logger::getInstance().setFile(false, "");
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count() /
+               static_cast<double>(num_logs);
+    };
+
+    const int samples = 1000000;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < samples; ++i) {
+        volatile auto stamp = LogClock::now().nanos;
+        (void)stamp;
+    }
+    auto mid = std::chrono::steady_clock::now();
+    for (int i = 0; i < samples; ++i) {
+        volatile auto ticks = LogTickClock::ticks();
+        (void)ticks;
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    double realtime = run("perf_clock_realtime.log", ClockSource::Realtime);
+    double tsc = run("perf_clock_tsc.log", ClockSource::Tsc);
+    Logger::getInstance().setClockSource(ClockSource::Realtime);
+
+    std::cout << "clock_gettime(REALTIME): "
+              << std::chrono::duration_cast<std::chrono::nanoseconds>(mid - start).count() / static_cast<double>(samples)
+              << " ns/call" << std::endl;
+    std::cout << "LogTickClock::ticks():   "
+              << std::chrono::duration_cast<std::chrono::nanoseconds>(end - mid).count() / static_cast<double>(samples)
+              << " ns/call (rdtsc: " << (LogTickClock::useTsc() ? "yes" : "no") << ")" << std::endl;
+    std::cout << "Async call, Realtime:    " << realtime << " ns/call" << std::endl;
+    std::cout << "Async call, Tsc:         " << tsc << " ns/call" << std::endl;
+
+    EXPECT_GT(realtime, 0);
+    EXPECT_GT(tsc, 0);
+}
+
+// Test 11: Filtered calls with expensive arguments (stream vs level-guarded macro)
+TEST_F(PerformanceTest, FilteredExpensiveArguments) {
+    const int num_logs = 1000000;
+    int evaluated = 0;
+    auto expensive = [&evaluated](int i) {
+        ++evaluated;
+        char tmp[64];
+        std::snprintf(tmp, sizeof(tmp), "payload %d %.3f", i, i * 0.5);
+        return std::string(tmp) + std::string(128, 'x');
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < num_logs; ++i) {
+        Logger::debug() << "stream " << expensive(i) << ' ' << i;
+    }
+    auto mid = std::chrono::steady_clock::now();
+    const int stream_evaluated = evaluated;
+    for (int i = 0; i < num_logs; ++i) {
+        LOG_DEBUG << "macro " << expensive(i) << ' ' << i;
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    const double stream_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(mid - start).count() /
+                             static_cast<double>(num_logs);
+    const double macro_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end - mid).count() /
+                            static_cast<double>(num_logs);
+    std::cout << "Filtered Logger::debug() << expensive(): " << stream_ns << " ns/call" << std::endl;
+    std::cout << "Filtered LOG_DEBUG << expensive():       " << macro_ns << " ns/call" << std::endl;
+
+    EXPECT_EQ(stream_evaluated, num_logs);
+    EXPECT_EQ(evaluated, num_logs);  // The macro never evaluated its operands
+    EXPECT_LT(macro_ns * 10, stream_ns);
+}
+
+// Test 12: Rendering cost with and without the cached call-site prefix
+TEST_F(PerformanceTest, CachedSitePrefixRendering) {
+    const int num_records = 200000;
+    const int rounds = 7;
+    const char message[] = "order filled";
+    const LogSite& site = LOGGER_SITE(LogLevel::INFO, nullptr);
+    LogRecord uncached{LogLevel::INFO, site.line, site.file, std::time(nullptr), 0, 0, 0,
+                       message, sizeof(message) - 1, false};
+    LogRecord cached = uncached;
+    cached.site = &site;
+
+    auto run = [num_records](const LogRecord& record) {
+        LogRenderer renderer;
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < num_records; ++i) {
+            if (renderer.bytes() > (1 << 20)) renderer.clear();
+            renderer.append(record);
+        }
+        auto end = std::chrono::steady_clock::now();
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count() /
+               static_cast<double>(num_records);
+    };
+
+    // Interleave the two variants and keep the best round of each so scheduler noise cancels out
+    double uncached_ns = std::numeric_limits<double>::max();
+    double cached_ns = std::numeric_limits<double>::max();
+    for (int round = 0; round < rounds; ++round) {
+        uncached_ns = std::min(uncached_ns, run(uncached));
+        cached_ns = std::min(cached_ns, run(cached));
+    }
+    std::cout << "Render, per-record prefix: " << uncached_ns << " ns/record" << std::endl;
+    std::cout << "Render, cached prefix:     " << cached_ns << " ns/record" << std::endl;
+
+    EXPECT_LT(cached_ns, uncached_ns);
+
+    // The cached prefix renders exactly the same line
+    EXPECT_TRUE(site.prefix->ready());
+    LogRenderer renderer;
+    renderer.append(uncached);
+    renderer.append(cached);
+    auto lines = renderer.lines();
+    ASSERT_EQ(lines.size(), 2u);
+    EXPECT_EQ(lines[0].text, lines[1].text);
+    EXPECT_NE(std::string(lines[1].text).find(" [INFO] test_performance.cpp:" + std::to_string(site.line) +
+                                             " - order filled\n"), std::string::npos) << lines[1].text;
+}
+
+// Test 13: {} format API vs the equivalent stream chain producing the same text
+TEST_F(PerformanceTest, FormatApiVersusStream) {
+    // Records are rendered but discarded, so only the caller-side formatting and rendering is timed
+    class DiscardSink : public LogSink {
+    protected:
+        void write(std::span<const LogLine>) override {}
+    };
+    auto sink = std::make_shared<DiscardSink>();
+    Logger::getInstance().addSink(sink);
+    const int num_logs = 50000;
+    const int rounds = 7;
+    const double price = 101.256;
+
+    auto time_per_call = [num_logs](auto&& body) {
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < num_logs; ++i) {
+            body(i);
+        }
+        auto end = std::chrono::steady_clock::now();
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count() /
+               static_cast<double>(num_logs);
+    };
+
+    // Interleave the two forms and keep the best round of each so scheduler noise cancels out
+    double stream_ns = std::numeric_limits<double>::max();
+    double format_ns = std::numeric_limits<double>::max();
+    for (int round = 0; round < rounds; ++round) {
+        stream_ns = std::min(stream_ns, time_per_call([&](int i) {
+            Logger::info() << "order " << i << " filled at " << price << " qty " << (i & 1023);
+        }));
+        format_ns = std::min(format_ns, time_per_call([&](int i) {
+            Logger::infof("order {} filled at {:.4f} qty {}", i, price, i & 1023);
+        }));
+    }
+    std::cout << "Logger::info() << ...:  " << stream_ns << " ns/call" << std::endl;
+    std::cout << "Logger::infof(\"{}\"):   " << format_ns << " ns/call" << std::endl;
+    Logger::getInstance().removeSink(sink);
+
+    // Same text, but the format path copies literals whole and reuses the call site's cached prefix
+    EXPECT_LT(format_ns, stream_ns);
+}
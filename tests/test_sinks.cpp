@@ -0,0 +1,368 @@
+#include <gtest/gtest.h>
+#include "Logger.hpp"
+#include "test_utils/test_helpers.hpp"
+#include <thread>
+#include <vector>
+#include <sstream>
+#include <algorithm>
+#include <regex>
+
+// Sink that records every rendered line and the size of each batch
+class CollectingSink : public LogSink {
+public:
+    std::vector<std::string> lines() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return lines_;
+    }
+
+    size_t max_batch() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return maxBatch_;
+    }
+
+protected:
+    void write(std::span<const LogLine> lines) override {
+        maxBatch_ = std::max(maxBatch_, lines.size());
+        for (const LogLine& line : lines) {
+            lines_.emplace_back(line.text);
+        }
+    }
+
+private:
+    std::vector<std::string> lines_;
+    size_t maxBatch_ = 0;
+};
+
+// Sink that blocks inside write() until released
+class BlockingSink : public LogSink {
+public:
+    std::atomic<bool> entered{false};
+    std::atomic<bool> release{false};
+
+protected:
+    void write(std::span<const LogLine>) override {
+        entered = true;
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (!release && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+};
+
+class SinkTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        Logger::getInstance().setLevel(LogLevel::DEBUG);
+        Logger::getInstance().setConsole(false);
+    }
+
+    void TearDown() override {
+        for (const auto& sink : added_) {
+            Logger::getInstance().removeSink(sink);
+        }
+        Logger::getInstance().setAsync(false);
+        Logger::getInstance().setFile(false, "");
+        Logger::getInstance().setConsole(true);
+        cleanup_temp_logs();
+    }
+
+    void add(const std::shared_ptr<LogSink>& sink) {
+        added_.push_back(sink);
+        Logger::getInstance().addSink(sink);
+    }
+
+    void cleanup_temp_logs() {
+        auto temp_dir = std::filesystem::temp_directory_path();
+        for (const auto& entry : std::filesystem::directory_iterator(temp_dir)) {
+            std::string filename = entry.path().filename().string();
+            if (filename.find("sink_") == 0) {
+                std::filesystem::remove(entry.path());
+            }
+        }
+    }
+
+    std::string read_logs(const std::string& prefix) {
+        std::string content;
+        auto temp_dir = std::filesystem::temp_directory_path();
+        for (const auto& entry : std::filesystem::directory_iterator(temp_dir)) {
+            if (entry.path().filename().string().find(prefix) == 0) {
+                std::ifstream file(entry.path());
+                std::stringstream buffer;
+                buffer << file.rdbuf();
+                content += buffer.str();
+            }
+        }
+        return content;
+    }
+
+    std::vector<std::shared_ptr<LogSink>> added_;
+};
+
+// Test 1: A custom sink receives the same rendered line as the file
+TEST_F(SinkTest, CustomSinkReceivesRenderedLine) {
+    test_utils::TempFile temp_base("sink_custom.log");
+    Logger::getInstance().setFile(true, temp_base.string());
+    auto sink = std::make_shared<CollectingSink>();
+    add(sink);
+
+    Logger::getInstance().log(LogLevel::INFO, "custom sink line", "test.cpp", 12);
+
+    auto lines = sink->lines();
+    ASSERT_EQ(lines.size(), 1u);
+    EXPECT_NE(lines[0].find("[INFO] test.cpp:12 - custom sink line\n"), std::string::npos);
+    EXPECT_EQ(read_logs("sink_custom"), lines[0]);
+}
+
+// Test 2: Per-sink level keeps an errors-only file separate from the main log
+TEST_F(SinkTest, ErrorsOnlyFileSink) {
+    test_utils::TempFile temp_main("sink_main.log");
+    test_utils::TempFile temp_errors("sink_errors.log");
+    Logger::getInstance().setFile(true, temp_main.string());
+
+    auto errors = std::make_shared<FileSink>();
+    errors->setLevel(LogLevel::ERROR);
+    ASSERT_TRUE(errors->open(temp_errors.string()));
+    add(errors);
+
+    Logger::info() << "routine info";
+    Logger::warning() << "routine warning";
+    Logger::error() << "disk failure";
+    errors->close();
+
+    std::string main_content = read_logs("sink_main");
+    std::string error_content = read_logs("sink_errors");
+    EXPECT_NE(main_content.find("routine info"), std::string::npos);
+    EXPECT_NE(main_content.find("disk failure"), std::string::npos);
+    EXPECT_EQ(error_content.find("routine"), std::string::npos);
+    EXPECT_NE(error_content.find("disk failure"), std::string::npos);
+}
+
+// Test 3: Removed sinks stop receiving records
+TEST_F(SinkTest, RemoveSink) {
+    auto sink = std::make_shared<CollectingSink>();
+    Logger::getInstance().addSink(sink);
+    Logger::info() << "before removal";
+    Logger::getInstance().removeSink(sink);
+    Logger::info() << "after removal";
+
+    auto lines = sink->lines();
+    ASSERT_EQ(lines.size(), 1u);
+    EXPECT_NE(lines[0].find("before removal"), std::string::npos);
+}
+
+// Test 4: The async backend delivers records to sinks in batches
+TEST_F(SinkTest, AsyncDeliversBatches) {
+    auto sink = std::make_shared<CollectingSink>();
+    add(sink);
+    Logger::getInstance().setAsync(true);
+
+    for (int i = 0; i < 2000; ++i) {
+        Logger::info() << "batched " << i;
+    }
+    Logger::getInstance().drain();
+
+    auto lines = sink->lines();
+    ASSERT_EQ(lines.size(), 2000u);
+    EXPECT_NE(lines.front().find("batched 0\n"), std::string::npos);
+    EXPECT_NE(lines.back().find("batched 1999\n"), std::string::npos);
+    EXPECT_GT(sink->max_batch(), 1u);
+}
+
+// Test 5: A stalled sink does not block records it does not accept
+TEST_F(SinkTest, SlowSinkDoesNotBlockOthers) {
+    test_utils::TempFile temp_base("sink_slow.log");
+    Logger::getInstance().setFile(true, temp_base.string());
+    auto slow = std::make_shared<BlockingSink>();
+    slow->setLevel(LogLevel::ERROR);
+    add(slow);
+
+    std::thread stalled([]() {
+        Logger::error() << "stalled error";
+    });
+    while (!slow->entered) {
+        std::this_thread::yield();
+    }
+
+    // The slow sink holds only its own lock; the file sink keeps accepting records
+    Logger::info() << "not blocked";
+    EXPECT_NE(read_logs("sink_slow").find("not blocked"), std::string::npos);
+
+    slow->release = true;
+    stalled.join();
+}
+
+#ifdef LOGGER_HAS_ZLIB
+// Inflate a multi-member gzip file the way zcat does
+static std::string inflate_all(const std::string& packed) {
+    std::string out;
+    z_stream zs{};
+    inflateInit2(&zs, 16 + 15);
+    zs.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(packed.data()));
+    zs.avail_in = static_cast<uInt>(packed.size());
+    char buffer[1 << 16];
+    while (zs.avail_in > 0) {
+        zs.next_out = reinterpret_cast<Bytef*>(buffer);
+        zs.avail_out = sizeof(buffer);
+        int rc = inflate(&zs, Z_NO_FLUSH);
+        out.append(buffer, sizeof(buffer) - zs.avail_out);
+        if (rc == Z_STREAM_END) {
+            inflateReset(&zs);
+        } else if (rc != Z_OK) {
+            break;
+        }
+    }
+    inflateEnd(&zs);
+    return out;
+}
+
+static std::string read_binary(const std::filesystem::path& path) {
+    std::ifstream file(path, std::ios::binary);
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    return buffer.str();
+}
+
+// Test 6: Framed sink output is a valid gzip stream and any frame can be read alone
+TEST_F(SinkTest, FramedFileSinkSeekable) {
+    auto path = std::filesystem::temp_directory_path() / "sink_framed.log.gz";
+    auto framed = std::make_shared<FramedFileSink>();
+    FramedFileOptions options;
+    options.frameSize = 64 * 1024;
+    options.maxFrameAge = std::chrono::milliseconds(0);
+    framed->setOptions(options);
+    ASSERT_TRUE(framed->open(path.string()));
+    add(framed);
+
+    for (int i = 0; i < 30000; ++i) {
+        Logger::debug() << "framed record " << i << " state=" << (i % 17) << " user=" << (i % 1000);
+    }
+    framed->close();
+
+    std::string packed = read_binary(path);
+    std::string all = inflate_all(packed);
+    EXPECT_EQ(std::count(all.begin(), all.end(), '\n'), 30000);
+    EXPECT_NE(all.find("framed record 29999 "), std::string::npos);
+    // Repetitive log text compresses well
+    EXPECT_LT(packed.size() * 5, all.size());
+
+    FramedLogReader reader;
+    ASSERT_TRUE(reader.open(path.string()));
+    ASSERT_GT(reader.frameCount(), 10u);
+    EXPECT_EQ(reader.rawSize(), all.size());
+
+    // Each frame starts on a record boundary and matches the same range of the full stream
+    size_t middle = reader.frameCount() / 2;
+    std::string text;
+    ASSERT_TRUE(reader.readFrame(middle, text));
+    const LogFrameInfo& info = reader.frame(middle);
+    EXPECT_EQ(text, all.substr(info.rawOffset, info.rawSize));
+    EXPECT_EQ(text.back(), '\n');
+    EXPECT_TRUE(std::regex_search(text.substr(0, 20), std::regex("^\\d{4}-\\d{2}-\\d{2} ")));
+
+    EXPECT_EQ(reader.findOffset(info.rawOffset), middle);
+    EXPECT_EQ(reader.findOffset(info.rawOffset + info.rawSize - 1), middle);
+    EXPECT_EQ(reader.findOffset(reader.rawSize()), reader.frameCount());
+    EXPECT_EQ(reader.findTime(0), 0u);
+    EXPECT_LE(reader.frame(reader.findTime(info.firstTime)).firstTime, info.firstTime);
+}
+
+// Test 7: Lost index is rebuilt from frame headers and a torn tail is dropped on reopen
+TEST_F(SinkTest, FramedFileSinkRecovers) {
+    auto path = std::filesystem::temp_directory_path() / "sink_recover.log.gz";
+    FramedFileOptions options;
+    options.frameSize = 16 * 1024;
+    options.maxFrameAge = std::chrono::milliseconds(0);
+    {
+        auto framed = std::make_shared<FramedFileSink>();
+        framed->setOptions(options);
+        ASSERT_TRUE(framed->open(path.string()));
+        add(framed);
+        for (int i = 0; i < 5000; ++i) {
+            Logger::info() << "first run " << i;
+        }
+        framed->close();
+        Logger::getInstance().removeSink(framed);
+    }
+
+    FramedLogReader indexed;
+    ASSERT_TRUE(indexed.open(path.string()));
+    const size_t frames = indexed.frameCount();
+    ASSERT_GT(frames, 3u);
+
+    // Drop the index and append a torn frame, as after a crash mid-write
+    std::filesystem::remove(path.string() + ".idx");
+    std::string partial = read_binary(path).substr(0, 40);
+    std::ofstream(path, std::ios::binary | std::ios::app) << partial;
+
+    FramedLogReader rebuilt;
+    ASSERT_TRUE(rebuilt.open(path.string()));
+    ASSERT_EQ(rebuilt.frameCount(), frames);
+    for (size_t i = 0; i < frames; ++i) {
+        EXPECT_EQ(rebuilt.frame(i).offset, indexed.frame(i).offset);
+        EXPECT_EQ(rebuilt.frame(i).rawSize, indexed.frame(i).rawSize);
+        EXPECT_EQ(rebuilt.frame(i).firstTime, indexed.frame(i).firstTime);
+    }
+
+    auto resumed = std::make_shared<FramedFileSink>();
+    resumed->setOptions(options);
+    ASSERT_TRUE(resumed->open(path.string()));
+    add(resumed);
+    Logger::info() << "second run";
+    resumed->close();
+
+    std::string all = inflate_all(read_binary(path));
+    EXPECT_EQ(std::count(all.begin(), all.end(), '\n'), 5001);
+    FramedLogReader reader;
+    ASSERT_TRUE(reader.open(path.string()));
+    EXPECT_EQ(reader.frameCount(), frames + 1);
+    std::string last;
+    ASSERT_TRUE(reader.readFrame(frames, last));
+    EXPECT_NE(last.find("second run\n"), std::string::npos);
+}
+#endif
+
+// Test 8: Records filtered by the global or sink level do not consume sequence numbers
+TEST_F(SinkTest, FilteredRecordsTakeNoSequence) {
+    auto sink = std::make_shared<CollectingSink>();
+    sink->setLevel(LogLevel::INFO);
+    add(sink);
+    Logger::getInstance().setSequenceNumbers(true);
+
+    Logger::info() << "kept 1";
+    Logger::debug() << "below sink level";
+    Logger::getInstance().log(LogLevel::DEBUG, "below sink level", "test.cpp", 1);
+    Logger::info() << "kept 2";
+    Logger::getInstance().setLevel(LogLevel::WARNING);
+    Logger::info() << "below global level";
+    Logger::getInstance().log(LogLevel::INFO, "below global level", "test.cpp", 2);
+    Logger::warning() << "kept 3";
+    Logger::getInstance().setSequenceNumbers(false);
+
+    auto lines = sink->lines();
+    ASSERT_EQ(lines.size(), 3u);
+    std::vector<uint64_t> sequences;
+    for (const std::string& line : lines) {
+        size_t hash = line.find(" #");
+        ASSERT_NE(hash, std::string::npos) << line;
+        sequences.push_back(std::stoull(line.substr(hash + 2)));
+    }
+    EXPECT_EQ(sequences[1], sequences[0] + 1);
+    EXPECT_EQ(sequences[2], sequences[1] + 1);
+}
+
+#ifdef LOGGER_HAS_ZLIB
+// Test 9: Opening a file that is not in framed format fails and leaves its bytes untouched
+TEST_F(SinkTest, FramedFileSinkKeepsForeignFile) {
+    auto path = std::filesystem::temp_directory_path() / "sink_plain.log";
+    const std::string original = "2026-02-18 13:25:30 [INFO] main.cpp:16 - plain text log\n";
+    std::ofstream(path, std::ios::binary) << original;
+
+    auto framed = std::make_shared<FramedFileSink>();
+    EXPECT_FALSE(framed->open(path.string()));
+    EXPECT_FALSE(framed->isOpen());
+    framed.reset();
+
+    EXPECT_EQ(read_binary(path), original);
+    EXPECT_FALSE(std::filesystem::exists(path.string() + ".idx"));
+}
+#endif